@@ -9,6 +9,7 @@
    INCLUDE
  ******************************************************************************/
 
+#include <stdint.h>
 #include <string>
 
 /******************************************************************************
@@ -31,4 +32,9 @@ typedef std::string String;
 void          set_millis(unsigned long const millis);
 unsigned long millis();
 
+uint16_t      word(uint8_t const high, uint8_t const low);
+void          randomSeed(unsigned long const seed);
+long          random(long const min, long const max);
+int           analogRead(uint8_t const pin);
+
 #endif /* TEST_ARDUINO_H_ */
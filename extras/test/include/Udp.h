@@ -0,0 +1,34 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+#ifndef TEST_UDP_H_
+#define TEST_UDP_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Subset of the Arduino UDP interface used by the library */
+class UDP
+{
+public:
+  virtual ~UDP() { }
+
+  virtual uint8_t begin(uint16_t port) = 0;
+  virtual void    stop() = 0;
+  virtual int     beginPacket(const char * host, uint16_t port) = 0;
+  virtual int     endPacket() = 0;
+  virtual size_t  write(const uint8_t * buffer, size_t size) = 0;
+  virtual int     parsePacket() = 0;
+  virtual int     read(unsigned char * buffer, size_t len) = 0;
+};
+
+#endif /* TEST_UDP_H_ */
@@ -0,0 +1,63 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+#ifndef INCLUDE_BENCH_UTIL_H_
+#define INCLUDE_BENCH_UTIL_H_
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <PropertyContainer.h>
+
+#include <memory>
+#include <vector>
+
+/**************************************************************************************
+   NAMESPACE
+ **************************************************************************************/
+
+namespace bench
+{
+
+/**************************************************************************************
+   CLASS DECLARATION
+ **************************************************************************************/
+
+/* Container of generated properties cycling through int, float, bool, String, Location,
+ * ColoredLight and Television, named property_<index>. Light payload identifiers are only
+ * assigned if there are no more properties than the 255 identifiers available.
+ */
+class MixedPropertyContainer
+{
+public:
+  MixedPropertyContainer(int const num_properties);
+
+  inline PropertyContainer & container() { return _container; }
+  inline bool hasIdentifiers() const { return _has_identifiers; }
+
+  /* Encode every property into a single message, return its length */
+  size_t encodeAll(bool const lightPayload);
+  inline uint8_t const * message() const { return _message.data(); }
+
+  /* Map data as decoded from a message updating every attribute of property index */
+  inline CborMapDataArena & mapData(size_t const index) { return _map_data[index]; }
+  inline String const & name(size_t const index) const { return _names[index]; }
+
+private:
+  std::vector<std::unique_ptr<Property>> _properties;
+  std::vector<String> _names;
+  std::vector<CborMapDataArena> _map_data;
+  std::vector<uint8_t> _message;
+  PropertyContainer _container;
+  bool _has_identifiers;
+};
+
+/**************************************************************************************
+   NAMESPACE
+ **************************************************************************************/
+
+} /* bench */
+
+#endif /* INCLUDE_BENCH_UTIL_H_ */
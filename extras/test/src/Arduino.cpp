@@ -8,6 +8,8 @@
 
 #include <Arduino.h>
 
+#include <stdlib.h>
+
 /******************************************************************************
    GLOBAL VARIABLES
  ******************************************************************************/
@@ -27,3 +29,23 @@ unsigned long millis()
 {
   return current_millis;
 }
+
+uint16_t word(uint8_t const high, uint8_t const low)
+{
+  return static_cast<uint16_t>((high << 8) | low);
+}
+
+void randomSeed(unsigned long const seed)
+{
+  srand(seed);
+}
+
+long random(long const min, long const max)
+{
+  return min + (rand() % (max - min));
+}
+
+int analogRead(uint8_t const /* pin */)
+{
+  return 0;
+}
@@ -0,0 +1,97 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <string>
+
+#include <util/BenchUtil.h>
+#include <util/CBORTestUtil.h>
+#include <CBORDecoder.h>
+
+/**************************************************************************************
+   BENCHMARK CODE
+ **************************************************************************************/
+
+TEST_CASE("Encoding, decoding and updating generated property containers", "[!benchmark][CBOR]")
+{
+  for (int const num_properties : {10, 100, 1000})
+  {
+    bench::MixedPropertyContainer mixed(num_properties);
+    std::string const suffix = ", " + std::to_string(num_properties) + " properties";
+
+    for (bool const light_payload : {false, true})
+    {
+      /* Light payload identifiers are 8 bit wide */
+      if (light_payload && !mixed.hasIdentifiers())
+        continue;
+
+      std::string const payload = light_payload ? ", light payload" : "";
+      size_t const length = mixed.encodeAll(light_payload);
+      REQUIRE(length > 0);
+      WARN(num_properties << " properties" << payload << ": " << length << " bytes");
+
+      BENCHMARK("CBOREncoder::encode" + payload + suffix) {
+        return mixed.encodeAll(light_payload);
+      };
+
+      mixed.encodeAll(light_payload);
+      BENCHMARK("CBORDecoder::decode" + payload + suffix) {
+        CBORDecoder::decode(mixed.container(), mixed.message(), length);
+        return length;
+      };
+    }
+
+    BENCHMARK("updateProperty" + suffix) {
+      for (int i = 0; i < num_properties; i++)
+        updateProperty(mixed.container(), mixed.name(i), 0, false, &mixed.mapData(i));
+      return num_properties;
+    };
+  }
+}
+
+TEST_CASE("Decoding multi-value property payloads", "[!benchmark][CBOR]")
+{
+  PropertyContainer cloud_container, property_container;
+
+  CloudTelevision cloud_tv = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+  CloudSchedule cloud_schedule = CloudSchedule(1633305600, 1633651200, 600, 1140850708);
+  addPropertyToContainer(cloud_container, cloud_tv, "tv", Permission::ReadWrite, 1).publishOnDemand();
+  addPropertyToContainer(cloud_container, cloud_schedule, "schedule", Permission::ReadWrite, 2).publishOnDemand();
+
+  CloudTelevision tv = CloudTelevision(false, 0, false, PlaybackCommands::Stop, InputValue::AUX1, 0);
+  CloudSchedule schedule = CloudSchedule(0, 0, 0, 0);
+  addPropertyToContainer(property_container, tv, "tv", Permission::ReadWrite, 1);
+  addPropertyToContainer(property_container, schedule, "schedule", Permission::ReadWrite, 2);
+
+  for (bool const light_payload : {false, true})
+  {
+    std::string const payload_name = light_payload ? ", light payload" : "";
+
+    cloud_schedule.requestUpdate();
+    std::vector<uint8_t> const schedule_payload = cbor::encode(cloud_container, light_payload);
+    cloud_tv.requestUpdate();
+    std::vector<uint8_t> const tv_payload = cbor::encode(cloud_container, light_payload);
+
+    CBORDecoder::decode(property_container, tv_payload.data(), tv_payload.size());
+    CBORDecoder::decode(property_container, schedule_payload.data(), schedule_payload.size());
+    REQUIRE(tv.getValue().cha == 7);
+    REQUIRE(schedule.getValue().msk == 1140850708);
+
+    BENCHMARK("CloudTelevision" + payload_name) {
+      CBORDecoder::decode(property_container, tv_payload.data(), tv_payload.size());
+      return tv_payload.size();
+    };
+
+    BENCHMARK("CloudSchedule" + payload_name) {
+      CBORDecoder::decode(property_container, schedule_payload.data(), schedule_payload.size());
+      return schedule_payload.size();
+    };
+  }
+}
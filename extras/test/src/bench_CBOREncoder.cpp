@@ -0,0 +1,199 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <PropertyContainer.h>
+#include <CBOREncoder.h>
+
+/**************************************************************************************
+   CONSTANTS
+ **************************************************************************************/
+
+/* Bytes added to every published message besides the CBOR payload:
+ * MQTT fixed header (1) + remaining length (2) + topic length (2) + "/a/t/<thing id>/e/o" (45)
+ * TLS record header (5) + AES-GCM explicit nonce (8) + tag (16)
+ */
+static size_t const MESSAGE_OVERHEAD = 1 + 2 + 2 + 45 + 5 + 8 + 16;
+
+/**************************************************************************************
+   GLOBAL VARIABLES
+ **************************************************************************************/
+
+static size_t append_count = 0;
+
+/**************************************************************************************
+   TEST HELPER CLASSES
+ **************************************************************************************/
+
+/* Counts how many times a property is appended to a message. Without a size hint the
+ * encoder appends until TinyCBOR runs out of memory, rolls the last property back and
+ * appends it again into the next message.
+ */
+template <typename T, bool USE_SIZE_HINT>
+class CountingProperty : public T
+{
+public:
+  template <typename... Args>
+  CountingProperty(Args... args) : T(args...) { }
+
+  virtual CborError appendAttributesToCloud(CborEncoder * encoder) override {
+    append_count++;
+    return T::appendAttributesToCloud(encoder);
+  }
+  virtual size_t encodedSizeHint(bool const lightPayload) const override {
+    return USE_SIZE_HINT ? T::encodedSizeHint(lightPayload) : 0;
+  }
+};
+
+/* The mixed set of properties of test_encode.cpp */
+template <bool USE_SIZE_HINT>
+struct MixedProperties
+{
+  CountingProperty<CloudInt,          USE_SIZE_HINT> int_test{1};
+  CountingProperty<CloudBool,         USE_SIZE_HINT> bool_test{false};
+  CountingProperty<CloudFloat,        USE_SIZE_HINT> float_test{2.0f};
+  CountingProperty<CloudString,       USE_SIZE_HINT> str_test;
+  CountingProperty<CloudLocation,     USE_SIZE_HINT> location_test{2.0f, 3.0f};
+  CountingProperty<CloudColor,        USE_SIZE_HINT> color_test{2.0f, 2.0f, 2.0f};
+  CountingProperty<CloudColoredLight, USE_SIZE_HINT> colored_light_test{true, 2.0f, 2.0f, 2.0f};
+  CountingProperty<CloudTelevision,   USE_SIZE_HINT> tv_test{true, 50, false, PlaybackCommands::Play, InputValue::TV, 7};
+  CountingProperty<CloudDimmedLight,  USE_SIZE_HINT> dimmed_light_test{true, 2.0f};
+  CountingProperty<CloudSchedule,     USE_SIZE_HINT> schedule_test{1633305600, 1633651200, 600, 1140850708};
+
+  PropertyContainer property_container;
+
+  MixedProperties()
+  {
+    str_test = "str_test";
+    addPropertyToContainer(property_container, int_test,           "int_test",           Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, bool_test,          "bool_test",          Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, float_test,         "float_test",         Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, str_test,           "str_test",           Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, location_test,      "location_test",      Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, color_test,         "color_test",         Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, colored_light_test, "colored_light_test", Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, tv_test,            "tv_test",            Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, dimmed_light_test,  "dimmed_light_test",  Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, schedule_test,      "schedule_test",      Permission::ReadWrite).publishOnDemand();
+  }
+
+  /* Request every property and encode until all of them are sent, return the number of messages */
+  size_t publishAll(size_t const buffer_size)
+  {
+    for (Property * p : property_container)
+      p->requestUpdate();
+
+    uint8_t buf[256];
+    int bytes_encoded = 0;
+    unsigned int current_property_index = 0;
+    size_t messages = 0;
+    do {
+      CBOREncoder::encode(property_container, buf, buffer_size, bytes_encoded, current_property_index, false);
+      if (bytes_encoded > 0)
+        messages++;
+    } while (bytes_encoded > 0);
+    return messages;
+  }
+};
+
+/**************************************************************************************
+   BENCHMARK CODE
+ **************************************************************************************/
+
+TEST_CASE("Encoding the mixed property set into small messages", "[!benchmark][CBOREncoder]")
+{
+  size_t const buffer_size = 128;
+
+  MixedProperties<false> rollback;
+  MixedProperties<true>  size_hint;
+
+  append_count = 0;
+  size_t const rollback_messages = rollback.publishAll(buffer_size);
+  size_t const rollback_appends = append_count;
+
+  append_count = 0;
+  size_t const size_hint_messages = size_hint.publishAll(buffer_size);
+  size_t const size_hint_appends = append_count;
+
+  WARN("rollback:  " << rollback_appends << " appends for " << rollback.property_container.size() << " properties in " << rollback_messages << " messages");
+  WARN("size hint: " << size_hint_appends << " appends for " << size_hint.property_container.size() << " properties in " << size_hint_messages << " messages");
+
+  /* With an exact size hint every property is appended exactly once */
+  CHECK(size_hint_appends == size_hint.property_container.size());
+  /* A single pass: at most the last property of each message is appended twice */
+  CHECK(rollback_appends <= rollback.property_container.size() + rollback_messages);
+  CHECK(size_hint_messages <= rollback_messages);
+
+  BENCHMARK("rollback, 10 properties, 128 byte messages") {
+    return rollback.publishAll(buffer_size);
+  };
+
+  BENCHMARK("size hint, 10 properties, 128 byte messages") {
+    return size_hint.publishAll(buffer_size);
+  };
+}
+
+TEST_CASE("Bytes on wire per property for different message sizes", "[!benchmark][CBOREncoder]")
+{
+  int const num_properties = 100;
+
+  PropertyContainer property_container;
+  std::vector<std::unique_ptr<CloudFloat>> properties;
+
+  for (int i = 0; i < num_properties; i++) {
+    properties.emplace_back(new CloudFloat(i * 0.5f));
+    addPropertyToContainer(property_container, *properties.back(), "temperature_" + std::to_string(i), Permission::ReadWrite).publishOnDemand();
+  }
+
+  /* Publish every property once, return the bytes sent including the per message overhead */
+  auto publishAll = [&](std::vector<uint8_t> & buf) -> size_t
+  {
+    for (Property * p : property_container)
+      p->requestUpdate();
+
+    int bytes_encoded = 0;
+    unsigned int current_property_index = 0;
+    size_t bytes_on_wire = 0;
+    do {
+      CBOREncoder::encode(property_container, buf.data(), buf.size(), bytes_encoded, current_property_index, false);
+      if (bytes_encoded > 0)
+        bytes_on_wire += bytes_encoded + MESSAGE_OVERHEAD;
+    } while (bytes_encoded > 0);
+    return bytes_on_wire;
+  };
+
+  std::vector<uint8_t> buf_256(256), buf_1024(1024), buf_4096(4096);
+
+  size_t const wire_256  = publishAll(buf_256);
+  size_t const wire_1024 = publishAll(buf_1024);
+  size_t const wire_4096 = publishAll(buf_4096);
+
+  WARN(" 256 byte messages: " << wire_256  << " bytes on wire, " << (wire_256  / num_properties) << " per property");
+  WARN("1024 byte messages: " << wire_1024 << " bytes on wire, " << (wire_1024 / num_properties) << " per property");
+  WARN("4096 byte messages: " << wire_4096 << " bytes on wire, " << (wire_4096 / num_properties) << " per property");
+
+  CHECK(wire_1024 < wire_256);
+  CHECK(wire_4096 < wire_1024);
+
+  BENCHMARK("100 properties, 256 byte messages") {
+    return publishAll(buf_256);
+  };
+
+  BENCHMARK("100 properties, 1024 byte messages") {
+    return publishAll(buf_1024);
+  };
+
+  BENCHMARK("100 properties, 4096 byte messages") {
+    return publishAll(buf_4096);
+  };
+}
@@ -0,0 +1,124 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <util/BenchUtil.h>
+#include <CBORDecoder.h>
+#include <IoTCloudMessageDecoder.h>
+#include <IoTCloudMessageEncoder.h>
+#include <MessageDecoder.h>
+#include <MessageEncoder.h>
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Wrap a property message into a LastValuesUpdateCmd: tag(67072) array(1) bytes(length) */
+static std::vector<uint8_t> lastValuesUpdate(uint8_t const * data, size_t const length)
+{
+  std::vector<uint8_t> payload = {0xDA, 0x00, 0x01, 0x06, 0x00, 0x81};
+
+  if (length < 24) {
+    payload.push_back(0x40 | length);
+  } else if (length <= 0xFF) {
+    payload.push_back(0x58);
+    payload.push_back(length);
+  } else if (length <= 0xFFFF) {
+    payload.push_back(0x59);
+    payload.push_back(length >> 8);
+    payload.push_back(length);
+  } else {
+    payload.push_back(0x5A);
+    payload.push_back(length >> 24);
+    payload.push_back(length >> 16);
+    payload.push_back(length >> 8);
+    payload.push_back(length);
+  }
+
+  payload.insert(payload.end(), data, data + length);
+  return payload;
+}
+
+/**************************************************************************************
+   BENCHMARK CODE
+ **************************************************************************************/
+
+TEST_CASE("Encoding and decoding command messages", "[!benchmark][CBOR]")
+{
+  uint8_t buffer[512];
+
+  ThingBeginCmd thing_begin;
+  thing_begin.c.id = CommandId::ThingBeginCmdId;
+  strcpy(thing_begin.params.thing_id, "e4494d55-872a-4fd2-9646-92f87949394c");
+
+  DeviceBeginCmd device_begin;
+  device_begin.c.id = CommandId::DeviceBeginCmdId;
+  strcpy(device_begin.params.lib_version, "2.0.0");
+
+  /* tag(66560) array(1) text(36) "e4494d55-872a-4fd2-9646-92f87949394c" */
+  uint8_t const thing_update[] = {0xDA, 0x00, 0x01, 0x04, 0x00, 0x81, 0x78, 0x24,
+                                  0x65, 0x34, 0x34, 0x39, 0x34, 0x64, 0x35, 0x35,
+                                  0x2D, 0x38, 0x37, 0x32, 0x61, 0x2D, 0x34, 0x66,
+                                  0x64, 0x32, 0x2D, 0x39, 0x36, 0x34, 0x36, 0x2D,
+                                  0x39, 0x32, 0x66, 0x38, 0x37, 0x39, 0x34, 0x39,
+                                  0x33, 0x39, 0x34, 0x63};
+
+  BENCHMARK("CBORMessageEncoder::encode, ThingBeginCmd") {
+    size_t bytes_encoded = sizeof(buffer);
+    CBORMessageEncoder encoder;
+    encoder.encode((Message*)&thing_begin, buffer, bytes_encoded);
+    return bytes_encoded;
+  };
+
+  BENCHMARK("CBORMessageEncoder::encode, DeviceBeginCmd") {
+    size_t bytes_encoded = sizeof(buffer);
+    CBORMessageEncoder encoder;
+    encoder.encode((Message*)&device_begin, buffer, bytes_encoded);
+    return bytes_encoded;
+  };
+
+  BENCHMARK("CBORMessageDecoder::decode, ThingUpdateCmd") {
+    CommandDown command;
+    CBORMessageDecoder decoder;
+    return decoder.decode((Message*)&command, thing_update, sizeof(thing_update));
+  };
+}
+
+TEST_CASE("Decoding last values of generated property containers", "[!benchmark][CBOR]")
+{
+  for (int const num_properties : {10, 100, 1000})
+  {
+    bench::MixedPropertyContainer mixed(num_properties);
+    size_t const length = mixed.encodeAll(false);
+    std::vector<uint8_t> const payload = lastValuesUpdate(mixed.message(), length);
+
+    CommandDown command;
+    CBORMessageDecoder decoder;
+    REQUIRE(decoder.decode((Message*)&command, payload.data(), payload.size()) == MessageDecoder::Status::Complete);
+    REQUIRE(command.c.id == LastValuesUpdateCmdId);
+    REQUIRE(command.lastValuesUpdateCmd.params.length == length);
+
+    WARN(num_properties << " properties: " << payload.size() << " bytes of last values");
+
+    BENCHMARK("LastValuesUpdateCmd, " + std::to_string(num_properties) + " properties") {
+      CommandDown last_values;
+      CBORMessageDecoder last_values_decoder;
+      last_values_decoder.decode((Message*)&last_values, payload.data(), payload.size());
+      CBORDecoder::decode(mixed.container(), last_values.lastValuesUpdateCmd.params.last_values,
+                          last_values.lastValuesUpdateCmd.params.length, true);
+      return length;
+    };
+  }
+}
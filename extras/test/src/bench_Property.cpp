@@ -0,0 +1,102 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+
+#include <PropertyContainer.h>
+
+/**************************************************************************************
+   GLOBAL VARIABLES
+ **************************************************************************************/
+
+static size_t allocation_count = 0;
+
+/**************************************************************************************
+   ALLOCATION HOOKS
+ **************************************************************************************/
+
+void * operator new(std::size_t size)
+{
+  allocation_count++;
+  void * ptr = malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void * ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  free(ptr);
+}
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+static CborError encodeOnce(Property & property)
+{
+  uint8_t buf[256];
+  CborEncoder encoder, array_encoder;
+  cbor_encoder_init(&encoder, buf, sizeof(buf), 0);
+  cbor_encoder_create_array(&encoder, &array_encoder, CborIndefiniteLength);
+  return property.append(&array_encoder, false);
+}
+
+/* Encode the property 100k times, report the elapsed time and the heap allocations */
+static size_t encode100k(Property & property, char const * type)
+{
+  int const num_encodes = 100000;
+
+  size_t const allocations_before = allocation_count;
+  std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_encodes; i++)
+    encodeOnce(property);
+  std::chrono::steady_clock::time_point const stop = std::chrono::steady_clock::now();
+  size_t const allocations = allocation_count - allocations_before;
+
+  WARN(type << ": " << num_encodes << " encodes in "
+       << std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count() << " ms, "
+       << allocations << " allocations");
+  return allocations;
+}
+
+/**************************************************************************************
+   BENCHMARK CODE
+ **************************************************************************************/
+
+TEST_CASE("Encoding multi-value properties", "[!benchmark][Property]")
+{
+  PropertyContainer property_container;
+
+  CloudTelevision tv = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+  CloudColoredLight colored_light = CloudColoredLight(true, 2.0f, 2.0f, 2.0f);
+
+  addPropertyToContainer(property_container, tv, "tv", Permission::ReadWrite);
+  addPropertyToContainer(property_container, colored_light, "colored_light", Permission::ReadWrite);
+
+  CHECK(encode100k(tv, "CloudTelevision") == 0);
+  CHECK(encode100k(colored_light, "CloudColoredLight") == 0);
+
+  BENCHMARK("CloudTelevision, single encode") {
+    return encodeOnce(tv);
+  };
+
+  BENCHMARK("CloudColoredLight, single encode") {
+    return encodeOnce(colored_light);
+  };
+}
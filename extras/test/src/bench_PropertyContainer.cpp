@@ -0,0 +1,129 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include <PropertyContainer.h>
+#include <CBOREncoder.h>
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Reference implementation of the encoder scan as it was when the container was a std::list */
+static int listScan(std::list<Property *> & prop_list, unsigned int const current_property_index)
+{
+  int num_to_update = 0;
+  std::list<Property *>::iterator iter = prop_list.begin();
+  std::advance(iter, current_property_index);
+
+  for(; iter != prop_list.end(); iter++)
+  {
+    Property * p = * iter;
+    if (p->shouldBeUpdated() && p->isReadableByCloud())
+      num_to_update++;
+  }
+  return num_to_update;
+}
+
+static int containerScan(PropertyContainer & prop_cont, unsigned int const current_property_index)
+{
+  int num_to_update = 0;
+  PropertyContainer::iterator iter = prop_cont.begin() + current_property_index;
+
+  for(; iter != prop_cont.end(); iter++)
+  {
+    Property * p = * iter;
+    if (p->shouldBeUpdated() && p->isReadableByCloud())
+      num_to_update++;
+  }
+  return num_to_update;
+}
+
+/**************************************************************************************
+   BENCHMARK CODE
+ **************************************************************************************/
+
+TEST_CASE("Scan of the property container done on every update()", "[!benchmark][PropertyContainer]")
+{
+  int const num_properties = 200;
+
+  PropertyContainer property_container;
+  std::list<Property *> property_list;
+  std::vector<std::unique_ptr<CloudInt>> properties;
+
+  for (int i = 0; i < num_properties; i++) {
+    properties.emplace_back(new CloudInt(0));
+    property_list.push_back(&addPropertyToContainer(property_container, *properties.back(), "property_" + std::to_string(i), Permission::ReadWrite));
+  }
+
+  /* Bring every property in sync with the cloud so that a scan finds nothing to send */
+  uint8_t buf[256];
+  int bytes_encoded = 0;
+  unsigned int current_property_index = 0;
+  do {
+    CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, current_property_index, false);
+  } while (bytes_encoded > 0);
+
+  BENCHMARK("std::list, 200 properties, full scan") {
+    return listScan(property_list, 0);
+  };
+
+  BENCHMARK("PropertyContainer, 200 properties, full scan") {
+    return containerScan(property_container, 0);
+  };
+
+  BENCHMARK("std::list, 200 properties, resume at 150") {
+    return listScan(property_list, 150);
+  };
+
+  BENCHMARK("PropertyContainer, 200 properties, resume at 150") {
+    return containerScan(property_container, 150);
+  };
+
+  BENCHMARK("CBOREncoder::encode, 200 properties") {
+    unsigned int index = 0;
+    return CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, index, false);
+  };
+}
+
+TEST_CASE("Idle update() with 150 properties", "[!benchmark][PropertyContainer]")
+{
+  int const num_properties = 150;
+
+  PropertyContainer property_container;
+  std::list<Property *> property_list;
+  std::vector<std::unique_ptr<CloudInt>> properties;
+
+  for (int i = 0; i < num_properties; i++) {
+    properties.emplace_back(new CloudInt(0));
+    property_list.push_back(&addPropertyToContainer(property_container, *properties.back(), "property_" + std::to_string(i), Permission::ReadWrite));
+  }
+
+  uint8_t buf[256];
+  int bytes_encoded = 0;
+  unsigned int current_property_index = 0;
+  do {
+    CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, current_property_index, false);
+  } while (bytes_encoded > 0);
+
+  BENCHMARK("every property polled, 150 properties") {
+    return listScan(property_list, 0);
+  };
+
+  BENCHMARK("pending properties only, 150 properties") {
+    updateTimestampOnLocallyChangedProperties(property_container);
+    return CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, current_property_index, false);
+  };
+}
@@ -0,0 +1,74 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include <PropertyContainer.h>
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Reference implementation of the name lookup as it was before the hashed name index */
+static Property * linearGetProperty(std::list<Property *> & prop_list, String const & name)
+{
+  std::list<Property *>::iterator iter;
+
+  iter = std::find_if(prop_list.begin(),
+                      prop_list.end(),
+                      [name](Property * p) -> bool
+                      {
+                        return (p->name() == name);
+                      });
+
+  if (iter == prop_list.end())
+    return nullptr;
+  else
+    return (*iter);
+}
+
+/**************************************************************************************
+   BENCHMARK CODE
+ **************************************************************************************/
+
+TEST_CASE("Lookup of every property by name, as done by a full last values sync", "[!benchmark][getProperty]")
+{
+  for (int const num_properties : {10, 100, 500})
+  {
+    PropertyContainer property_container;
+    std::list<Property *> property_list;
+    std::vector<std::unique_ptr<CloudFloat>> properties;
+    std::vector<String> names;
+
+    for (int i = 0; i < num_properties; i++) {
+      properties.emplace_back(new CloudFloat(0.0f));
+      names.push_back("property_" + std::to_string(i));
+      property_list.push_back(&addPropertyToContainer(property_container, *properties.back(), names.back(), Permission::ReadWrite));
+    }
+
+    BENCHMARK("linear scan, " + std::to_string(num_properties) + " properties") {
+      int found = 0;
+      for (String const & name : names)
+        found += (linearGetProperty(property_list, name) != nullptr);
+      return found;
+    };
+
+    BENCHMARK("name index, " + std::to_string(num_properties) + " properties") {
+      int found = 0;
+      for (String const & name : names)
+        found += (getProperty(property_container, name) != nullptr);
+      return found;
+    };
+  }
+}
@@ -0,0 +1,254 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdlib.h>
+#include <new>
+#include <string>
+
+#include <util/CBORTestUtil.h>
+#include <CBORDecoder.h>
+#include <CBOREncoder.h>
+#include <PropertyContainer.h>
+
+/**************************************************************************************
+   GLOBAL VARIABLES
+ **************************************************************************************/
+
+static size_t allocation_count = 0;
+
+/**************************************************************************************
+   ALLOCATION HOOKS
+ **************************************************************************************/
+
+/* Replacing the global allocation functions affects the whole test binary,
+ * all they do on top of the default ones is counting the allocations.
+ */
+void * operator new(std::size_t size)
+{
+  allocation_count++;
+  void * ptr = malloc(size ? size : 1);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void * ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+  free(ptr);
+}
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Encode until no property is left to send, return the number of heap allocations */
+static size_t countAllocationsPerEncodeCycle(PropertyContainer & property_container, bool const light_payload)
+{
+  uint8_t buf[256];
+  int bytes_encoded = 0;
+  unsigned int current_property_index = 0;
+
+  size_t const allocations_before = allocation_count;
+  do {
+    CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, current_property_index, light_payload);
+  } while (bytes_encoded > 0);
+  return allocation_count - allocations_before;
+}
+
+/* Decode the payload into the property container, return the number of heap allocations */
+static size_t countAllocationsPerDecode(PropertyContainer & property_container, std::vector<uint8_t> const & payload)
+{
+  size_t const allocations_before = allocation_count;
+  CBORDecoder::decode(property_container, payload.data(), payload.size());
+  return allocation_count - allocations_before;
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Encoding properties does not allocate heap memory", "[ArduinoCloudThing::allocations]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+
+  CloudInt          int_test      = 0;
+  CloudFloat        float_test    = 0.0f;
+  CloudBool         bool_test     = false;
+  CloudString       str_test      = String("off");
+  CloudLocation     location_test = CloudLocation(0.0f, 0.0f);
+  CloudColoredLight light_test    = CloudColoredLight(false, 0.0f, 0.0f, 0.0f);
+  CloudTelevision   tv_test       = CloudTelevision(false, 0, false, PlaybackCommands::Stop, InputValue::AUX1, 0);
+
+  addPropertyToContainer(property_container, int_test, "int_test", Permission::ReadWrite, 1);
+  addPropertyToContainer(property_container, float_test, "float_test", Permission::ReadWrite, 2);
+  addPropertyToContainer(property_container, bool_test, "bool_test", Permission::ReadWrite, 3);
+  addPropertyToContainer(property_container, str_test, "str_test", Permission::ReadWrite, 4);
+  addPropertyToContainer(property_container, location_test, "location_test", Permission::ReadWrite, 5);
+  addPropertyToContainer(property_container, light_test, "light_test", Permission::ReadWrite, 6);
+  addPropertyToContainer(property_container, tv_test, "tv_test", Permission::ReadWrite, 7);
+
+  /* Send the initial values once, only the following updates are measured */
+  countAllocationsPerEncodeCycle(property_container, false);
+
+  WHEN("All properties are changed and encoded again")
+  {
+    set_millis(1000);
+    int_test = 1;
+    float_test = 1.0f;
+    bool_test = true;
+    str_test = "on";
+    location_test = Location(1.0f, 1.0f);
+    light_test = ColoredLight(true, 1.0f, 1.0f, 1.0f);
+    tv_test = Television(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+
+    THEN("No heap memory is allocated") {
+      REQUIRE(countAllocationsPerEncodeCycle(property_container, false) == 0);
+    }
+  }
+
+  WHEN("All properties are changed and encoded again using light payloads")
+  {
+    set_millis(1000);
+    int_test = 2;
+    float_test = 2.0f;
+    light_test.setHue(2.0f);
+    tv_test.setVolume(20);
+
+    THEN("No heap memory is allocated") {
+      REQUIRE(countAllocationsPerEncodeCycle(property_container, true) == 0);
+    }
+  }
+
+  WHEN("Nothing has changed")
+  {
+    set_millis(1000);
+
+    THEN("No heap memory is allocated") {
+      REQUIRE(countAllocationsPerEncodeCycle(property_container, false) == 0);
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("Property names are interned", "[ArduinoCloudThing::allocations]")
+{
+  PropertyContainer first_container, second_container;
+  CloudInt first = 0, second = 0;
+
+  addPropertyToContainer(first_container, first, "shared_name", Permission::ReadWrite);
+  addPropertyToContainer(second_container, second, "shared_name", Permission::ReadWrite);
+
+  REQUIRE(first.name() == "shared_name");
+  REQUIRE(first.nameCStr() == second.nameCStr());
+  REQUIRE(first == second);
+
+  WHEN("Many names are interned")
+  {
+    size_t const count = 200;
+    CloudInt first_ints[count], second_ints[count];
+    for (size_t i = 0; i < count; i++) {
+      String const name = String("interned_") + std::to_string(i);
+      addPropertyToContainer(first_container, first_ints[i], name, Permission::ReadWrite);
+      addPropertyToContainer(second_container, second_ints[i], name, Permission::ReadWrite);
+    }
+
+    THEN("Every name is stored once") {
+      for (size_t i = 0; i < count; i++) {
+        REQUIRE(first_ints[i].nameCStr() == second_ints[i].nameCStr());
+        REQUIRE(first_ints[i].name() == String("interned_") + std::to_string(i));
+      }
+      REQUIRE(first.nameCStr() == second.nameCStr());
+    }
+  }
+
+  WHEN("A multi-value property is copied after its keys have been cached")
+  {
+    PropertyContainer color_container, copy_container;
+    CloudColor color = CloudColor(2.0f, 2.0f, 2.0f);
+    addPropertyToContainer(color_container, color, "color", Permission::ReadWrite).publishOnDemand();
+    color.requestUpdate();
+    std::vector<uint8_t> const payload = cbor::encode(color_container, true);
+
+    THEN("The copy does not release the keys of the original") {
+      {
+        CloudColor copy = color;
+        addPropertyToContainer(copy_container, copy, "copy", Permission::ReadWrite).publishOnDemand();
+        copy.requestUpdate();
+        cbor::encode(copy_container, true);
+      }
+      color.requestUpdate();
+      REQUIRE(cbor::encode(color_container, true) == payload);
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("Decoding numeric properties does not allocate heap memory", "[ArduinoCloudThing::allocations]")
+{
+  set_millis(0);
+
+  /* Names are longer than any small string buffer, copying one would allocate */
+  PropertyContainer cloud_container, property_container;
+
+  CloudInt          cloud_int      = 7;
+  CloudBool         cloud_bool     = true;
+  CloudLocation     cloud_location = CloudLocation(45.0f, 9.0f);
+  CloudColoredLight cloud_light    = CloudColoredLight(true, 20.0f, 30.0f, 40.0f);
+
+  CloudInt          int_test      = 0;
+  CloudBool         bool_test     = false;
+  CloudLocation     location_test = CloudLocation(0.0f, 0.0f);
+  CloudColoredLight light_test    = CloudColoredLight(false, 0.0f, 0.0f, 0.0f);
+
+  addPropertyToContainer(cloud_container, cloud_int,      "integer_property_name", Permission::ReadWrite).publishOnChange(0.0f, 0);
+  addPropertyToContainer(cloud_container, cloud_bool,     "boolean_property_name", Permission::ReadWrite).publishOnChange(0.0f, 0);
+  addPropertyToContainer(cloud_container, cloud_location, "location_property",     Permission::ReadWrite).publishOnChange(0.0f, 0);
+  addPropertyToContainer(cloud_container, cloud_light,    "colored_light_prop",    Permission::ReadWrite).publishOnChange(0.0f, 0);
+
+  addPropertyToContainer(property_container, int_test,      "integer_property_name", Permission::ReadWrite);
+  addPropertyToContainer(property_container, bool_test,     "boolean_property_name", Permission::ReadWrite);
+  addPropertyToContainer(property_container, location_test, "location_property",     Permission::ReadWrite);
+  addPropertyToContainer(property_container, light_test,    "colored_light_prop",    Permission::ReadWrite);
+
+  WHEN("The payload uses full names")
+  {
+    std::vector<uint8_t> const payload = cbor::encode(cloud_container);
+    size_t const allocations = countAllocationsPerDecode(property_container, payload);
+
+    THEN("No heap memory is allocated") {
+      REQUIRE(int_test == 7);
+      REQUIRE(bool_test == true);
+      REQUIRE(location_test.getValue().lat == 45.0f);
+      REQUIRE(light_test.getValue().bri == 40.0f);
+      REQUIRE(allocations == 0);
+    }
+  }
+
+  WHEN("The payload uses SenML base names")
+  {
+    std::vector<uint8_t> const payload = cbor::encode(cloud_container, false, true);
+    size_t const allocations = countAllocationsPerDecode(property_container, payload);
+
+    THEN("No heap memory is allocated") {
+      REQUIRE(location_test.getValue().lon == 9.0f);
+      REQUIRE(light_test.getValue().hue == 20.0f);
+      REQUIRE(allocations == 0);
+    }
+  }
+}
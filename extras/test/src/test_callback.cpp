@@ -35,6 +35,11 @@ void externalCallbackV2()
   callback_called_protocol_v2 = true;
 }
 
+unsigned long customTime()
+{
+  return 1550138810;
+}
+
 /**************************************************************************************
    TEST CODE
  **************************************************************************************/
@@ -344,3 +349,34 @@ SCENARIO("After a connection/reconnection an incoming cbor payload is processed.
 
   REQUIRE(test == false);
 }
+
+/**************************************************************************************/
+
+SCENARIO("Local changes are timestamped with the time source passed to addPropertyToContainer", "[ArduinoCloudThing::callback]")
+{
+  PropertyContainer property_container;
+  CloudInt first = 0, second = 0;
+
+  addPropertyToContainer(property_container, first, "first", Permission::ReadWrite, -1, customTime);
+  addPropertyToContainer(property_container, second, "second", Permission::ReadWrite);
+
+  WHEN("The default time source is passed afterwards")
+  {
+    THEN("It applies to every property of the container") {
+      first = 1;
+      REQUIRE(first.getLastLocalChangeTimestamp() == getTime());
+    }
+  }
+
+  WHEN("A property is initialised again with its own time source")
+  {
+    second.init("second", Permission::ReadWrite, customTime);
+
+    THEN("The container uses it") {
+      first = 1;
+      second = 2;
+      REQUIRE(first.getLastLocalChangeTimestamp() == 1550138810);
+      REQUIRE(second.getLastLocalChangeTimestamp() == 1550138810);
+    }
+  }
+}
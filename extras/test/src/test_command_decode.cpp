@@ -305,7 +305,35 @@ SCENARIO("Test the decoding of command messages") {
 
       REQUIRE(command.c.id == LastValuesUpdateCmdId);
     }
-    free(command.lastValuesUpdateCmd.params.last_values);
+
+    THEN("The last values are not copied, they point into the message") {
+      REQUIRE(command.lastValuesUpdateCmd.params.last_values == payload + 7);
+      REQUIRE(command.lastValuesUpdateCmd.params.length == 13);
+    }
+  }
+
+  WHEN("Decode the LastValuesUpdateCmd message, but lastvalues is a chunked byte string")
+  {
+    CommandDown command;
+
+    /*
+      DA 00010600                        # tag(67072)
+        81                               # array(1)
+            5F                           # bytes(*)
+              42 0001                    # bytes(2)
+              FF                         # primitive(*)
+    */
+
+    uint8_t const payload[] = {0xDA, 0x00, 0x01, 0x06, 0x00, 0x81, 0x5F, 0x42,
+                               0x00, 0x01, 0xFF};
+
+    size_t payload_length = sizeof(payload) / sizeof(uint8_t);
+    CBORMessageDecoder decoder;
+    MessageDecoder::Status err =  decoder.decode((Message*)&command, payload, payload_length);
+
+    THEN("The decode is unsuccessful") {
+      REQUIRE(err == MessageDecoder::Status::Error);
+    }
   }
 
   WHEN("Decode the LastValuesUpdateCmd message, but lastvalues is an integer")
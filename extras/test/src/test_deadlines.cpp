@@ -0,0 +1,157 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <limits.h>
+
+#include <util/CBORTestUtil.h>
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("A property published periodically registers its next deadline", "[ArduinoCloudThing::deadline]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+  CloudInt test = 0;
+  addPropertyToContainer(property_container, test, "test", Permission::ReadWrite).publishEvery(2);
+
+  WHEN("The property has never been sent")
+  {
+    THEN("It is due immediately") {
+      REQUIRE(nextDeadlineMillis(property_container, 0) == 0);
+    }
+  }
+
+  WHEN("The property has been sent at t = 0 ms")
+  {
+    REQUIRE(cbor::encode(property_container).size() != 0);
+    REQUIRE(cbor::encode(property_container).size() == 0);
+
+    THEN("The next deadline is at t = 2000 ms and the property is not visited before") {
+      REQUIRE(nextDeadlineMillis(property_container, 0) == 2000);
+      REQUIRE(property_container.nextPending(0) == property_container.size());
+    }
+
+    WHEN("t = 1999 ms")
+    {
+      set_millis(1999);
+
+      THEN("The property is not sent") {
+        REQUIRE(cbor::encode(property_container).size() == 0);
+        REQUIRE(nextDeadlineMillis(property_container, 1999) == 2000);
+      }
+    }
+
+    WHEN("t = 2500 ms")
+    {
+      set_millis(2500);
+
+      THEN("The deadline has passed, the property is sent and rescheduled") {
+        REQUIRE(nextDeadlineMillis(property_container, 2500) == 2500);
+        REQUIRE(cbor::encode(property_container).size() != 0);
+        REQUIRE(nextDeadlineMillis(property_container, 2500) == 4500);
+      }
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("A rate limited property registers the end of the rate limit as deadline", "[ArduinoCloudThing::deadline]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+  CloudInt test = 0;
+  addPropertyToContainer(property_container, test, "test", Permission::ReadWrite).publishOnChange(0, 500);
+
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  THEN("Without local changes there is no deadline") {
+    REQUIRE(nextDeadlineMillis(property_container, 0) == static_cast<unsigned long>(LONG_MAX));
+  }
+
+  WHEN("The property is changed before the rate limit expires")
+  {
+    set_millis(100);
+    test = 1;
+
+    THEN("The property is pending") {
+      REQUIRE(nextDeadlineMillis(property_container, 100) == 100);
+    }
+
+    THEN("It is held back until t = 500 ms") {
+      REQUIRE(cbor::encode(property_container).size() == 0);
+      REQUIRE(property_container.nextPending(0) == property_container.size());
+      REQUIRE(nextDeadlineMillis(property_container, 100) == 500);
+
+      set_millis(499);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+
+      set_millis(500);
+      REQUIRE(cbor::encode(property_container).size() != 0);
+      REQUIRE(nextDeadlineMillis(property_container, 500) == 500UL + LONG_MAX);
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("Deadlines of several properties are released in order", "[ArduinoCloudThing::deadline]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+  CloudInt slow = 0, fast = 0, medium = 0;
+  addPropertyToContainer(property_container, slow, "slow", Permission::ReadWrite).publishEvery(5);
+  addPropertyToContainer(property_container, fast, "fast", Permission::ReadWrite).publishEvery(1);
+  addPropertyToContainer(property_container, medium, "medium", Permission::ReadWrite).publishEvery(3);
+
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(nextDeadlineMillis(property_container, 0) == 1000);
+
+  set_millis(3000);
+  /* fast and medium are due, slow is not */
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(nextDeadlineMillis(property_container, 3000) == 4000);
+
+  WHEN("A periodic property is switched to publish on demand")
+  {
+    fast.publishOnDemand();
+
+    THEN("Its deadline is dropped") {
+      REQUIRE(nextDeadlineMillis(property_container, 3000) == 5000);
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("Deadlines survive the millis() overflow", "[ArduinoCloudThing::deadline]")
+{
+  unsigned long const t0 = ULONG_MAX - 500;
+  set_millis(t0);
+
+  PropertyContainer property_container;
+  CloudInt test = 0;
+  addPropertyToContainer(property_container, test, "test", Permission::ReadWrite).publishEvery(1);
+
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(nextDeadlineMillis(property_container, t0) == t0 + 1000);
+
+  set_millis(t0 + 999);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  set_millis(t0 + 1000);
+  REQUIRE(cbor::encode(property_container).size() != 0);
+}
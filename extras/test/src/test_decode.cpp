@@ -205,6 +205,37 @@ SCENARIO("Arduino Cloud Properties are decoded", "[ArduinoCloudThing::decode]")
 
   /************************************************************************************/
 
+  WHEN("Multiple properties are changed via CBOR message - light payload")
+  {
+    PropertyContainer property_container;
+
+    CloudInt   int_test   = 0;
+    CloudColor color_test = CloudColor(0.0, 0.0, 0.0);
+    CloudBool  bool_test  = true;
+
+    addPropertyToContainer(property_container, int_test, "int_test", Permission::ReadWrite, 1);
+    addPropertyToContainer(property_container, color_test, "color_test", Permission::ReadWrite, 2);
+    addPropertyToContainer(property_container, bool_test, "bool_test", Permission::ReadWrite, 3);
+
+    /* [{0: 1, 2: 7},{0: 258, 2: 2.0},{0: 514, 2: 3.0},{0: 770, 2: 4.0},{0: 3, 4: false},{0: 99, 2: 1}] */
+    uint8_t const payload[] = {0x86, 0xA2, 0x00, 0x01, 0x02, 0x07,
+                               0xA2, 0x00, 0x19, 0x01, 0x02, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00,
+                               0xA2, 0x00, 0x19, 0x02, 0x02, 0x02, 0xFA, 0x40, 0x40, 0x00, 0x00,
+                               0xA2, 0x00, 0x19, 0x03, 0x02, 0x02, 0xFA, 0x40, 0x80, 0x00, 0x00,
+                               0xA2, 0x00, 0x03, 0x04, 0xF4,
+                               0xA2, 0x00, 0x18, 0x63, 0x02, 0x01};
+    CBORDecoder::decode(property_container, payload, sizeof(payload) / sizeof(uint8_t));
+
+    REQUIRE(int_test == 7);
+    Color value_color_test = color_test.getValue();
+    REQUIRE(value_color_test.hue == Approx(2.0).epsilon(0.01));
+    REQUIRE(value_color_test.sat == Approx(3.0).epsilon(0.01));
+    REQUIRE(value_color_test.bri == Approx(4.0).epsilon(0.01));
+    REQUIRE(bool_test == false);
+  }
+
+  /************************************************************************************/
+
   WHEN("A ColoredLight property is changed via CBOR message")
   {
     PropertyContainer property_container;
@@ -255,6 +286,26 @@ SCENARIO("Arduino Cloud Properties are decoded", "[ArduinoCloudThing::decode]")
 
   /************************************************************************************/
 
+  WHEN("A Television property receives the same attribute twice via CBOR message")
+  {
+    PropertyContainer property_container;
+
+    CloudTelevision tv_test = CloudTelevision(false, 0, false, PlaybackCommands::Stop, InputValue::AUX1, 0);
+
+    addPropertyToContainer(property_container, tv_test, "test", Permission::ReadWrite);
+
+    /* [{0: "test:vol", 2: 10},{0: "test:cha", 2: 7},{0: "test:vol", 2: 50}] = 83 A2 00 68 74 65 73 74 3A 76 6F 6C 02 0A A2 00 68 74 65 73 74 3A 63 68 61 02 07 A2 00 68 74 65 73 74 3A 76 6F 6C 02 18 32 */
+    uint8_t const payload[] = {0x83, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x76, 0x6F, 0x6C, 0x02, 0x0A, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x63, 0x68, 0x61, 0x02, 0x07, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x76, 0x6F, 0x6C, 0x02, 0x18, 0x32};
+    CBORDecoder::decode(property_container, payload, sizeof(payload) / sizeof(uint8_t));
+
+    Television value_tv_test = tv_test.getValue();
+    REQUIRE(value_tv_test.vol == 50);
+    REQUIRE(value_tv_test.cha == 7);
+    REQUIRE(value_tv_test.swi == false);
+  }
+
+  /************************************************************************************/
+
   WHEN("A DimmedLight property is changed via CBOR message")
   {
     PropertyContainer property_container;
@@ -8,9 +8,15 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <math.h>
+#include <string.h>
+
+#include <cmath>
 #include <memory>
 
 #include <util/CBORTestUtil.h>
+#include <CBOREncoder.h>
+#include <CBORDecoder.h>
 #include "types/CloudWrapperBool.h"
 #include "types/CloudWrapperFloat.h"
 #include "types/CloudWrapperInt.h"
@@ -517,3 +523,562 @@ SCENARIO("Arduino Cloud Properties are encoded", "[ArduinoCloudThing::encode-1]"
   }
 
 }
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Compare the predicted size with the bytes the property takes in a message, without the array header and break */
+static void requireExactSizeHint(Property & property)
+{
+  PropertyContainer property_container;
+  addPropertyToContainer(property_container, property, "size_test", Permission::ReadWrite, 7);
+
+  size_t const hint = property.encodedSizeHint(false);
+  REQUIRE(cbor::encode(property_container, false).size() - 2 == hint);
+
+  property.publishOnDemand();
+  property.requestUpdate();
+  size_t const light_hint = property.encodedSizeHint(true);
+  REQUIRE(cbor::encode(property_container, true).size() - 2 == light_hint);
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("The encoded size of a property is predicted exactly", "[ArduinoCloudThing::encode-1]")
+{
+  WHEN("Properties of every type are encoded")
+  {
+    THEN("encodedSizeHint() returns the number of bytes appended to the message") {
+      CloudBool bool_test = true;
+      requireExactSizeHint(bool_test);
+      CloudInt int_small = 7, int_large = 1000000, int_negative = -70000;
+      requireExactSizeHint(int_small);
+      requireExactSizeHint(int_large);
+      requireExactSizeHint(int_negative);
+      CloudUnsignedInt uint_test = 4000000000U;
+      requireExactSizeHint(uint_test);
+      CloudFloat float_test = 2.5f;
+      requireExactSizeHint(float_test);
+      CloudString str_short, str_long;
+      str_short = "short";
+      str_long = "A string longer than twenty-three bytes";
+      requireExactSizeHint(str_short);
+      requireExactSizeHint(str_long);
+      CloudLocation location_test = CloudLocation(2.0f, 3.0f);
+      requireExactSizeHint(location_test);
+      CloudColor color_test = CloudColor(2.0, 2.0, 2.0);
+      requireExactSizeHint(color_test);
+      CloudSchedule schedule_test = CloudSchedule(1633305600, 1633651200, 600, 1140850708);
+      requireExactSizeHint(schedule_test);
+      CloudColoredLight colored_light_test = CloudColoredLight(true, 2.0, 2.0, 2.0);
+      requireExactSizeHint(colored_light_test);
+      CloudDimmedLight dimmed_light_test = CloudDimmedLight(true, 2.0);
+      requireExactSizeHint(dimmed_light_test);
+      CloudTelevision tv_test = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+      requireExactSizeHint(tv_test);
+
+      int int_value = -1;
+      String str_value = "wrapped";
+      CloudWrapperInt int_wrapper(int_value);
+      CloudWrapperString str_wrapper(str_value);
+      requireExactSizeHint(int_wrapper);
+      requireExactSizeHint(str_wrapper);
+    }
+  }
+
+  WHEN("The timestamp is encoded as well")
+  {
+    CloudInt int_test = 1;
+    int_test.encodeTimestamp();
+    int_test.setTimestamp(1633305600);
+
+    THEN("encodedSizeHint() accounts for it") {
+      requireExactSizeHint(int_test);
+    }
+  }
+
+  WHEN("The timestamp has milliseconds")
+  {
+    CloudInt int_test = 1;
+    int_test.encodeTimestamp();
+    int_test.setTimestampMillis(1633305600123ULL);
+
+    THEN("encodedSizeHint() accounts for the fractional time") {
+      requireExactSizeHint(int_test);
+    }
+  }
+}
+
+/**************************************************************************************
+   TEST HELPER CLASSES
+ **************************************************************************************/
+
+/* Encode into a buffer large enough for the whole batch, the default one holds 256 bytes */
+static std::vector<uint8_t> encodeBatch(PropertyContainer & property_container, bool const baseFields)
+{
+  int bytes_encoded = 0;
+  unsigned int starting_property_index = 0;
+  uint8_t buf[1024] = {0};
+
+  REQUIRE(CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, starting_property_index, false, baseFields) == CborNoError);
+  /* Every property has been sent in a single message */
+  REQUIRE(starting_property_index == 0);
+  return std::vector<uint8_t>(buf, buf + bytes_encoded);
+}
+
+/* Counts how many times a property is appended, a message encoded again appends it again */
+template <typename T>
+class AppendCounting : public T
+{
+public:
+  template <typename... Args>
+  AppendCounting(Args... args) : T(args...), append_count(0) { }
+
+  size_t append_count;
+
+  virtual CborError appendAttributesToCloud(CborEncoder * encoder) override {
+    append_count++;
+    return T::appendAttributesToCloud(encoder);
+  }
+};
+
+/* A property type which can not predict its encoded size, like most user defined ones */
+template <typename T>
+class WithoutSizeHint : public AppendCounting<T>
+{
+public:
+  template <typename... Args>
+  WithoutSizeHint(Args... args) : AppendCounting<T>(args...) { }
+
+  virtual size_t encodedSizeHint(bool const /* lightPayload */) const override {
+    return 0;
+  }
+};
+
+/* A batch of timestamped properties, as published after reconnecting */
+struct TimestampedProperties
+{
+  CloudInt          int_a = 1, int_b = 2, int_c = 3;
+  CloudLocation     location_test = CloudLocation(2.0f, 3.0f);
+  CloudColor        color_test = CloudColor(2.0f, 2.0f, 2.0f);
+  CloudColoredLight colored_light_test = CloudColoredLight(true, 2.0f, 2.0f, 2.0f);
+  CloudTelevision   tv_test = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+
+  PropertyContainer property_container;
+
+  TimestampedProperties(unsigned long const timestamp)
+  {
+    addPropertyToContainer(property_container, int_a,              "int_a",              Permission::ReadWrite);
+    addPropertyToContainer(property_container, location_test,      "location_test",      Permission::ReadWrite);
+    addPropertyToContainer(property_container, int_b,              "int_b",              Permission::ReadWrite);
+    addPropertyToContainer(property_container, color_test,         "color_test",         Permission::ReadWrite);
+    addPropertyToContainer(property_container, colored_light_test, "colored_light_test", Permission::ReadWrite);
+    addPropertyToContainer(property_container, tv_test,            "tv_test",            Permission::ReadWrite);
+    addPropertyToContainer(property_container, int_c,              "int_c",              Permission::ReadWrite);
+
+    unsigned long offset = 0;
+    for (Property * p : property_container) {
+      p->encodeTimestamp();
+      p->setTimestamp(timestamp + offset);
+      offset += 5;
+    }
+  }
+};
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Arduino Cloud Properties are encoded with SenML base fields", "[ArduinoCloudThing::encode-1]")
+{
+  WHEN("A timestamped 'Location' property is added")
+  {
+    PropertyContainer property_container;
+
+    CloudLocation location_test = CloudLocation(2.0f, 3.0f);
+    addPropertyToContainer(property_container, location_test, "loc", Permission::ReadWrite);
+    location_test.encodeTimestamp();
+    location_test.setTimestamp(1633305600);
+
+    /* [{-2: "loc:", -3: 1633305600, 0: "lat", 2: 2.0, 6: 0}, {0: "lon", 2: 3.0, 6: 0}]
+       = 9F A5 21 64 6C 6F 63 3A 22 1A 61 5A 44 00 00 63 6C 61 74 02 FA 40 00 00 00 06 00 A3 00 63 6C 6F 6E 02 FA 40 40 00 00 06 00 FF
+    */
+    std::vector<uint8_t> const expected = {0x9F, 0xA5, 0x21, 0x64, 0x6C, 0x6F, 0x63, 0x3A, 0x22, 0x1A, 0x61, 0x5A, 0x44, 0x00, 0x00, 0x63, 0x6C, 0x61, 0x74, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00, 0x06, 0x00, 0xA3, 0x00, 0x63, 0x6C, 0x6F, 0x6E, 0x02, 0xFA, 0x40, 0x40, 0x00, 0x00, 0x06, 0x00, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+    REQUIRE(actual == expected);
+  }
+
+  WHEN("A timestamped 'int' property follows a multi-value property")
+  {
+    PropertyContainer property_container;
+
+    CloudColor color_test = CloudColor(2.0f, 2.0f, 2.0f);
+    CloudInt   int_test = 1;
+    addPropertyToContainer(property_container, color_test, "c", Permission::ReadWrite);
+    addPropertyToContainer(property_container, int_test,   "i", Permission::ReadWrite);
+    color_test.encodeTimestamp();
+    color_test.setTimestamp(1633305600);
+    int_test.encodeTimestamp();
+    int_test.setTimestamp(1633305610);
+
+    THEN("The base name is cleared and the time is relative to the base time") {
+      /* [..., {-2: "", 0: "i", 2: 1, 6: 10}] = ... A4 21 60 00 61 69 02 01 06 0A FF */
+      std::vector<uint8_t> const expected_tail = {0xA4, 0x21, 0x60, 0x00, 0x61, 0x69, 0x02, 0x01, 0x06, 0x0A, 0xFF};
+      std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+      REQUIRE(actual.size() > expected_tail.size());
+      REQUIRE(std::vector<uint8_t>(actual.end() - expected_tail.size(), actual.end()) == expected_tail);
+    }
+  }
+
+  WHEN("Properties with long names are encoded into small messages")
+  {
+    PropertyContainer property_container;
+    std::vector<std::unique_ptr<AppendCounting<CloudColor>>> colors;
+    std::vector<std::unique_ptr<AppendCounting<CloudInt>>> ints;
+
+    for (int i = 0; i < 4; i++) {
+      colors.emplace_back(new AppendCounting<CloudColor>(2.0f, 2.0f, 2.0f));
+      ints.emplace_back(new AppendCounting<CloudInt>(i));
+      addPropertyToContainer(property_container, *colors.back(), "color_property_with_a_long_name_" + std::to_string(i), Permission::ReadWrite).encodeTimestamp();
+      addPropertyToContainer(property_container, *ints.back(), "int_property_with_a_long_name_" + std::to_string(i), Permission::ReadWrite).encodeTimestamp();
+      colors.back()->setTimestamp(1633305600 + i);
+      ints.back()->setTimestamp(1633305600 + i);
+    }
+
+    THEN("Every property is appended once, no message is encoded again") {
+      uint8_t buf[128];
+      int bytes_encoded = 0;
+      unsigned int current_property_index = 0;
+      size_t messages = 0;
+      do {
+        REQUIRE(CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, current_property_index, false, true) == CborNoError);
+        if (bytes_encoded > 0)
+          messages++;
+      } while ((bytes_encoded > 0) && (messages < 16));
+
+      REQUIRE(messages > 1);
+      for (int i = 0; i < 4; i++) {
+        REQUIRE(colors[i]->append_count == 1);
+        REQUIRE(ints[i]->append_count == 1);
+      }
+    }
+  }
+
+  WHEN("Properties without a size hint are encoded into small messages")
+  {
+    PropertyContainer property_container;
+    std::vector<std::unique_ptr<WithoutSizeHint<CloudColor>>> colors;
+
+    for (int i = 0; i < 8; i++) {
+      colors.emplace_back(new WithoutSizeHint<CloudColor>(2.0f, 2.0f, 2.0f));
+      addPropertyToContainer(property_container, *colors.back(), "c" + std::to_string(i), Permission::ReadWrite);
+    }
+
+    THEN("A property which does not fit is rolled back and appended again into the next message") {
+      uint8_t buf[128];
+      int bytes_encoded = 0;
+      unsigned int current_property_index = 0;
+      size_t messages = 0;
+      do {
+        REQUIRE(CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, current_property_index, false) == CborNoError);
+        if (bytes_encoded > 0) {
+          messages++;
+          REQUIRE(buf[0] == 0x9F);
+          REQUIRE(buf[bytes_encoded - 1] == 0xFF);
+        }
+      } while ((bytes_encoded > 0) && (messages < 16));
+
+      REQUIRE(messages > 1);
+      REQUIRE(messages < 8);
+      size_t appends = 0;
+      for (int i = 0; i < 8; i++) {
+        REQUIRE(colors[i]->append_count >= 1);
+        REQUIRE(colors[i]->append_count <= 2);
+        appends += colors[i]->append_count;
+      }
+      REQUIRE(appends > 8);
+      REQUIRE(appends <= 8 + messages);
+    }
+  }
+
+  WHEN("Timestamps with milliseconds are encoded")
+  {
+    PropertyContainer property_container;
+
+    CloudInt int_a = 1, int_b = 2;
+    addPropertyToContainer(property_container, int_a, "a", Permission::ReadWrite);
+    addPropertyToContainer(property_container, int_b, "b", Permission::ReadWrite);
+    int_a.encodeTimestamp();
+    int_a.setTimestampMillis(1633305600500ULL);
+    int_b.encodeTimestamp();
+    int_b.setTimestampMillis(1633305610750ULL);
+
+    THEN("Without base fields the time is a double precision float") {
+      /* [{0: "a", 2: 1, 6: 1633305600.5}, {0: "b", 2: 2, 6: 1633305610.75}] */
+      std::vector<uint8_t> const expected = {0x9F,
+        0xA3, 0x00, 0x61, 0x61, 0x02, 0x01, 0x06, 0xFB, 0x41, 0xD8, 0x56, 0x91, 0x00, 0x20, 0x00, 0x00,
+        0xA3, 0x00, 0x61, 0x62, 0x02, 0x02, 0x06, 0xFB, 0x41, 0xD8, 0x56, 0x91, 0x02, 0xB0, 0x00, 0x00,
+        0xFF};
+      REQUIRE(cbor::encode(property_container, false, false) == expected);
+    }
+
+    THEN("With base fields the base time is whole seconds and the time relative to it a single precision float") {
+      /* [{-3: 1633305600, 0: "a", 2: 1, 6: 0.5}, {0: "b", 2: 2, 6: 10.75}] */
+      std::vector<uint8_t> const expected = {0x9F,
+        0xA4, 0x22, 0x1A, 0x61, 0x5A, 0x44, 0x00, 0x00, 0x61, 0x61, 0x02, 0x01, 0x06, 0xFA, 0x3F, 0x00, 0x00, 0x00,
+        0xA3, 0x00, 0x61, 0x62, 0x02, 0x02, 0x06, 0xFA, 0x41, 0x2C, 0x00, 0x00,
+        0xFF};
+      REQUIRE(cbor::encode(property_container, false, true) == expected);
+    }
+  }
+
+  WHEN("A batch of timestamped properties is encoded")
+  {
+    TimestampedProperties plain(1633305600);
+    TimestampedProperties compact(1633305600);
+
+    std::vector<uint8_t> const plain_message = encodeBatch(plain.property_container, false);
+    std::vector<uint8_t> const compact_message = encodeBatch(compact.property_container, true);
+
+    THEN("The message is at least 25% smaller") {
+      INFO("plain: " << plain_message.size() << " bytes, with base fields: " << compact_message.size() << " bytes");
+      REQUIRE(plain_message.size() > 0);
+      REQUIRE((compact_message.size() * 4) <= (plain_message.size() * 3));
+    }
+
+    THEN("The message is decoded back into the same values and times") {
+      TimestampedProperties received(0);
+      received.int_a = 0;
+      received.int_c = 0;
+      received.location_test = Location(0.0f, 0.0f);
+      received.tv_test = Television(false, 0, true, PlaybackCommands::Stop, InputValue::HDMI1, 0);
+
+      CBORDecoder::decode(received.property_container, compact_message.data(), compact_message.size());
+
+      REQUIRE(received.int_a == 1);
+      REQUIRE(received.int_c == 3);
+      REQUIRE(received.location_test.getValue().lat == 2.0f);
+      REQUIRE(received.location_test.getValue().lon == 3.0f);
+      REQUIRE(received.tv_test.getSwitch() == true);
+      REQUIRE(received.tv_test.getVolume() == 50);
+      REQUIRE(received.tv_test.getChannel() == 7);
+      REQUIRE(received.int_a.getLastCloudChangeTimestamp() == 1633305600);
+      REQUIRE(received.tv_test.getLastCloudChangeTimestamp() == 1633305625);
+      REQUIRE(received.int_c.getLastCloudChangeTimestamp() == 1633305630);
+    }
+  }
+}
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Encoding of the value of a single float property, without the map and the name */
+static std::vector<uint8_t> encodeFloatValue(float const value)
+{
+  PropertyContainer property_container;
+  CloudFloat float_test = value;
+  addPropertyToContainer(property_container, float_test, "t", Permission::ReadWrite);
+
+  /* [{0: "t", 2: value}] = 9F A2 00 61 74 02 <value> FF */
+  std::vector<uint8_t> const actual = cbor::encode(property_container, false, false, true);
+  REQUIRE(actual.size() > 7);
+  return std::vector<uint8_t>(actual.begin() + 6, actual.end() - 1);
+}
+
+/* Encode value with the shortest float encoding and decode it again */
+static float roundTripFloat(CloudFloat & tx, CloudFloat & rx, PropertyContainer & rx_container, float const value)
+{
+  uint8_t buf[32];
+  CborEncoder encoder, array_encoder;
+  tx = value;
+  cbor_encoder_init(&encoder, buf, sizeof(buf), 0);
+  cbor_encoder_create_array(&encoder, &array_encoder, CborIndefiniteLength);
+  REQUIRE(tx.append(&array_encoder, false, true) == CborNoError);
+  REQUIRE(cbor_encoder_close_container(&encoder, &array_encoder) == CborNoError);
+
+  CBORDecoder::decode(rx_container, buf, cbor_encoder_get_buffer_size(&encoder, buf));
+  return rx;
+}
+
+static uint32_t floatBits(float const value)
+{
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float floatFromBits(uint32_t const bits)
+{
+  float value = 0.0f;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static float halfToFloat(uint16_t const half)
+{
+  /* Sign, then exponent and significand with the half bias of 15 and 10 fraction bits */
+  uint32_t const sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  int const exponent = (half >> 10) & 0x1F;
+  int const mantissa = half & 0x3FF;
+  if (exponent == 0x1F)
+    return floatFromBits(sign | 0x7F800000 | (static_cast<uint32_t>(mantissa) << 13));
+  float const magnitude = (exponent == 0) ? ldexpf(static_cast<float>(mantissa), -24) : ldexpf(static_cast<float>(mantissa + 1024), exponent - 25);
+  return floatFromBits(sign | floatBits(magnitude));
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Float values are encoded with the shortest exact representation", "[ArduinoCloudThing::encode-1]")
+{
+  WHEN("Integral values are encoded")
+  {
+    THEN("They are encoded as integers") {
+      REQUIRE(encodeFloatValue(0.0f)      == std::vector<uint8_t>{0x00});
+      REQUIRE(encodeFloatValue(2.0f)      == std::vector<uint8_t>{0x02});
+      REQUIRE(encodeFloatValue(-25.0f)    == std::vector<uint8_t>{0x38, 0x18});
+      REQUIRE(encodeFloatValue(1000.0f)   == std::vector<uint8_t>{0x19, 0x03, 0xE8});
+      REQUIRE(encodeFloatValue(65504.0f)  == std::vector<uint8_t>{0x19, 0xFF, 0xE0});
+      REQUIRE(encodeFloatValue(100000.0f) == std::vector<uint8_t>{0x1A, 0x00, 0x01, 0x86, 0xA0});
+    }
+  }
+
+  WHEN("Values exactly representable in half precision are encoded")
+  {
+    THEN("They are encoded as half floats") {
+      REQUIRE(encodeFloatValue(21.5f)    == std::vector<uint8_t>{0xF9, 0x4D, 0x60});
+      REQUIRE(encodeFloatValue(-0.0f)    == std::vector<uint8_t>{0xF9, 0x80, 0x00});
+      REQUIRE(encodeFloatValue(0.25f)    == std::vector<uint8_t>{0xF9, 0x34, 0x00});
+      REQUIRE(encodeFloatValue(-2.5f)    == std::vector<uint8_t>{0xF9, 0xC1, 0x00});
+      REQUIRE(encodeFloatValue(floatFromBits(0x33800000)) == std::vector<uint8_t>{0xF9, 0x00, 0x01}); /* 2^-24, smallest half subnormal */
+      REQUIRE(encodeFloatValue(INFINITY) == std::vector<uint8_t>{0xF9, 0x7C, 0x00});
+    }
+  }
+
+  WHEN("Values not exactly representable in half precision are encoded")
+  {
+    THEN("They are encoded in single precision") {
+      REQUIRE(encodeFloatValue(0.1f)     == std::vector<uint8_t>{0xFA, 0x3D, 0xCC, 0xCC, 0xCD});
+      REQUIRE(encodeFloatValue(21.55f)   == std::vector<uint8_t>{0xFA, 0x41, 0xAC, 0x66, 0x66});
+      REQUIRE(encodeFloatValue(1.0e10f)  == std::vector<uint8_t>{0xFA, 0x50, 0x15, 0x02, 0xF9});
+      REQUIRE(encodeFloatValue(floatFromBits(0x33000000)).size() == 5); /* 2^-25, below the half range */
+    }
+  }
+
+  WHEN("Values across the float range are encoded and decoded again")
+  {
+    PropertyContainer tx_container, rx_container;
+    CloudFloat tx, rx;
+    addPropertyToContainer(tx_container, tx, "t", Permission::ReadWrite);
+    addPropertyToContainer(rx_container, rx, "t", Permission::ReadWrite);
+
+    THEN("Every value is decoded bit by bit, NaN as NaN") {
+      std::vector<float> values;
+      /* Every half precision value, as float */
+      for (uint32_t half = 0; half < 0x10000; half++) {
+        values.push_back(halfToFloat(static_cast<uint16_t>(half)));
+      }
+      /* A sweep of the single precision bit patterns */
+      for (uint64_t bits = 0; bits <= 0xFFFFFFFFULL; bits += 0x10001ULL) {
+        values.push_back(floatFromBits(static_cast<uint32_t>(bits)));
+      }
+
+      size_t mismatches = 0;
+      for (float const value : values) {
+        float const decoded = roundTripFloat(tx, rx, rx_container, value);
+        bool const match = std::isnan(value) ? std::isnan(decoded) : (floatBits(decoded) == floatBits(value));
+        if (!match) {
+          mismatches++;
+          UNSCOPED_INFO("0x" << std::hex << floatBits(value) << " decoded as 0x" << floatBits(decoded));
+        }
+      }
+      REQUIRE(mismatches == 0);
+    }
+  }
+}
+
+SCENARIO("Only the changed attributes of a multi-value property are encoded", "[ArduinoCloudThing::encode-1]")
+{
+  PropertyContainer property_container;
+
+  CloudTelevision tv_test = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+  addPropertyToContainer(property_container, tv_test, "tv", Permission::ReadWrite, 1).publishOnChange(0.0f, 0).encodeChangedAttributesOnly();
+
+  std::vector<uint8_t> const first_message = cbor::encode(property_container);
+
+  WHEN("The property is sent for the first time")
+  {
+    THEN("Every attribute is encoded") {
+      /* Six records of 11 bytes, but the volume and the input which take 12 */
+      REQUIRE(first_message.size() == 2 + 6 * 11 + 2);
+    }
+  }
+
+  WHEN("A single attribute changes")
+  {
+    tv_test = Television(true, 60, false, PlaybackCommands::Play, InputValue::TV, 7);
+
+    THEN("Only that attribute is encoded") {
+      REQUIRE(tv_test.appendSizeHint(false) == 12);
+      /* [{0: "tv:vol", 2: 60}] = 9F A2 00 66 74 76 3A 76 6F 6C 02 18 3C FF */
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x66, 0x74, 0x76, 0x3A, 0x76, 0x6F, 0x6C, 0x02, 0x18, 0x3C, 0xFF};
+      std::vector<uint8_t> const actual = cbor::encode(property_container);
+      INFO("all attributes: " << first_message.size() << " bytes, changed attribute: " << actual.size() << " bytes");
+      REQUIRE(actual == expected);
+    }
+
+    THEN("The light payload keeps the identifier of the attribute") {
+      /* [{0: 513, 2: 60}] = 9F A2 00 19 02 01 02 18 3C FF */
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x19, 0x02, 0x01, 0x02, 0x18, 0x3C, 0xFF};
+      std::vector<uint8_t> const actual = cbor::encode(property_container, true);
+      REQUIRE(actual == expected);
+    }
+
+    THEN("The receiver keeps the other attributes") {
+      PropertyContainer rx_container;
+      CloudTelevision rx_tv = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+      addPropertyToContainer(rx_container, rx_tv, "tv", Permission::ReadWrite);
+
+      std::vector<uint8_t> const actual = cbor::encode(property_container);
+      CBORDecoder::decode(rx_container, actual.data(), actual.size());
+
+      REQUIRE(rx_tv.getVolume() == 60);
+      REQUIRE(rx_tv.getSwitch() == true);
+      REQUIRE(rx_tv.getChannel() == 7);
+    }
+  }
+
+  WHEN("An update is requested while an attribute has changed")
+  {
+    tv_test = Television(true, 60, false, PlaybackCommands::Play, InputValue::TV, 7);
+    tv_test.requestUpdate();
+
+    THEN("Every attribute is encoded") {
+      REQUIRE(cbor::encode(property_container).size() == first_message.size());
+    }
+  }
+
+  WHEN("Attributes of the other multi-value properties change")
+  {
+    CloudLocation location_test = CloudLocation(2.0f, 3.0f);
+    CloudColoredLight colored_light_test = CloudColoredLight(true, 2.0f, 2.0f, 2.0f);
+    addPropertyToContainer(property_container, location_test,      "loc",   Permission::ReadWrite).publishOnChange(0.0f, 0).encodeChangedAttributesOnly();
+    addPropertyToContainer(property_container, colored_light_test, "light", Permission::ReadWrite).publishOnChange(0.0f, 0).encodeChangedAttributesOnly();
+    size_t const full_size = cbor::encode(property_container).size();
+
+    location_test = Location(2.0f, 4.0f);
+    colored_light_test = ColoredLight(true, 2.0f, 2.0f, 50.0f);
+
+    THEN("One record per property is encoded") {
+      /* [{0: "loc:lon", 2: 4.0}, {0: "light:bri", 2: 50.0}] */
+      size_t const changed_size = cbor::encode(property_container).size();
+      INFO("all attributes: " << full_size << " bytes, changed attributes: " << changed_size << " bytes");
+      REQUIRE(changed_size == 2 + 16 + 18);
+    }
+  }
+}
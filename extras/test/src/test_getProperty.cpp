@@ -0,0 +1,125 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <PropertyContainer.h>
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Arduino Cloud Properties are looked up by name", "[ArduinoCloudThing::getProperty]")
+{
+  WHEN("The property container is empty")
+  {
+    PropertyContainer property_container;
+
+    THEN("No property is found") {
+      REQUIRE(getProperty(property_container, "test") == nullptr);
+    }
+  }
+
+  /**************************************************************************************/
+
+  WHEN("Many properties are added to the container")
+  {
+    PropertyContainer property_container;
+    std::vector<std::unique_ptr<CloudInt>> properties;
+
+    for (int i = 0; i < 500; i++) {
+      properties.emplace_back(new CloudInt(i));
+      addPropertyToContainer(property_container, *properties.back(), "property_" + std::to_string(i), Permission::ReadWrite);
+    }
+
+    THEN("Every property is found by its name") {
+      for (int i = 0; i < 500; i++) {
+        REQUIRE(getProperty(property_container, "property_" + std::to_string(i)) == properties[i].get());
+      }
+    }
+
+    THEN("Names which have not been added are not found") {
+      REQUIRE(getProperty(property_container, "property_500") == nullptr);
+      REQUIRE(getProperty(property_container, "property_") == nullptr);
+      REQUIRE(getProperty(property_container, "") == nullptr);
+    }
+  }
+
+  /**************************************************************************************/
+
+  WHEN("Two names have colliding hashes")
+  {
+    /* "costarring" and "liquid" share the same 32 bit FNV-1a hash */
+    REQUIRE(PropertyNameIndex::hash("costarring") == PropertyNameIndex::hash("liquid"));
+
+    PropertyContainer property_container;
+    CloudInt costarring = 1, liquid = 2;
+
+    addPropertyToContainer(property_container, costarring, "costarring", Permission::ReadWrite);
+    addPropertyToContainer(property_container, liquid, "liquid", Permission::ReadWrite);
+
+    THEN("Both properties are still resolved correctly") {
+      REQUIRE(getProperty(property_container, "costarring") == &costarring);
+      REQUIRE(getProperty(property_container, "liquid") == &liquid);
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("Arduino Cloud Properties are looked up by identifier", "[ArduinoCloudThing::getProperty]")
+{
+  WHEN("Properties are added with explicit identifiers")
+  {
+    PropertyContainer property_container;
+    CloudInt first = 1, second = 2;
+
+    addPropertyToContainer(property_container, first, "first", Permission::ReadWrite, 7);
+    addPropertyToContainer(property_container, second, "second", Permission::ReadWrite, 200);
+
+    THEN("Each property is found by its identifier") {
+      REQUIRE(getProperty(property_container, 7) == &first);
+      REQUIRE(getProperty(property_container, 200) == &second);
+      REQUIRE(getPropertyNameByIdentifier(property_container, 200) == "second");
+    }
+
+    THEN("Identifiers which have not been assigned are not found") {
+      REQUIRE(getProperty(property_container, 0) == nullptr);
+      REQUIRE(getProperty(property_container, 8) == nullptr);
+      REQUIRE(getProperty(property_container, 255) == nullptr);
+      REQUIRE(getProperty(property_container, 1000) == nullptr);
+      REQUIRE(getPropertyNameByIdentifier(property_container, 8) == "");
+    }
+
+    THEN("A light payload identifier resolves to the property in its least significant byte") {
+      REQUIRE(getPropertyNameByIdentifier(property_container, (3 << 8) + 7) == "first");
+    }
+  }
+
+  /**************************************************************************************/
+
+  WHEN("More properties than a light payload can address are added")
+  {
+    PropertyContainer property_container;
+    std::vector<std::unique_ptr<CloudInt>> properties;
+
+    for (int i = 0; i < 300; i++) {
+      properties.emplace_back(new CloudInt(i));
+      addPropertyToContainer(property_container, *properties.back(), "property_" + std::to_string(i), Permission::ReadWrite, i + 1);
+    }
+
+    THEN("Every property is found by its identifier") {
+      for (int i = 0; i < 300; i++) {
+        REQUIRE(getProperty(property_container, i + 1) == properties[i].get());
+      }
+    }
+  }
+}
@@ -0,0 +1,212 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string.h>
+
+#include <utility/mqtt/MqttOutboundQueue.h>
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Enqueue a message of length bytes all set to value, return false if the queue is full */
+static bool enqueue(MqttOutboundQueue & queue, uint8_t const value, size_t const length)
+{
+  uint8_t * slot = queue.reserve();
+  if (slot == nullptr)
+    return false;
+  memset(slot, value, length);
+  queue.commit(length);
+  return true;
+}
+
+/* Publish the next unsent message with packet_id, return its first byte or -1 if there is none */
+static int publish(MqttOutboundQueue & queue, uint16_t const packet_id, bool * dup = nullptr)
+{
+  uint8_t const * data = nullptr;
+  size_t length = 0;
+  bool is_dup = false;
+  if (!queue.nextUnsent(data, length, is_dup))
+    return -1;
+  queue.markSent(packet_id);
+  if (dup != nullptr)
+    *dup = is_dup;
+  return data[0];
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Outbound MQTT messages are kept until acknowledged", "[MqttOutboundQueue]")
+{
+  MqttOutboundQueue queue;
+  queue.begin(4, 64);
+
+  WHEN("The queue has not been allocated")
+  {
+    MqttOutboundQueue unallocated;
+
+    THEN("No message can be enqueued") {
+      REQUIRE(unallocated.reserve() == nullptr);
+      REQUIRE(unallocated.empty());
+    }
+  }
+
+  WHEN("More messages than the queue depth are enqueued")
+  {
+    THEN("The queue is full after depth messages") {
+      for (uint8_t i = 0; i < 4; i++)
+        REQUIRE(enqueue(queue, i, 10));
+      REQUIRE(queue.full());
+      REQUIRE_FALSE(enqueue(queue, 4, 10));
+      REQUIRE(queue.size() == 4);
+    }
+  }
+
+  WHEN("Messages are published")
+  {
+    for (uint8_t i = 0; i < 3; i++)
+      enqueue(queue, i, 10 + i);
+
+    THEN("They are published in order with their length and are in flight at the same time") {
+      uint8_t const * data = nullptr;
+      size_t length = 0;
+      bool dup = true;
+      for (uint8_t i = 0; i < 3; i++) {
+        REQUIRE(queue.nextUnsent(data, length, dup));
+        REQUIRE(data[0] == i);
+        REQUIRE(length == 10u + i);
+        REQUIRE_FALSE(dup);
+        queue.markSent(i + 1);
+      }
+      REQUIRE_FALSE(queue.nextUnsent(data, length, dup));
+      REQUIRE(queue.inFlight() == 3);
+      REQUIRE(queue.size() == 3);
+    }
+  }
+
+  WHEN("Messages are acknowledged")
+  {
+    for (uint8_t i = 0; i < 3; i++) {
+      enqueue(queue, i, 10);
+      publish(queue, 100 + i);
+    }
+    enqueue(queue, 3, 10);
+
+    THEN("The messages in flight are released by their packet id, the unsent ones stay") {
+      REQUIRE(queue.acknowledge(100));
+      REQUIRE(queue.size() == 3);
+      REQUIRE(queue.acknowledge(101));
+      REQUIRE(queue.acknowledge(102));
+      REQUIRE(queue.size() == 1);
+      REQUIRE_FALSE(queue.acknowledge(103));
+      REQUIRE(queue.size() == 1);
+      REQUIRE(publish(queue, 103) == 3);
+    }
+
+    THEN("The PUBACKs of other messages are ignored") {
+      REQUIRE_FALSE(queue.acknowledge(7));
+      REQUIRE(queue.size() == 4);
+      REQUIRE(queue.inFlight() == 3);
+    }
+
+    THEN("A PUBACK also releases the older messages in flight, acknowledged in order by the broker") {
+      REQUIRE(queue.acknowledge(101));
+      REQUIRE(queue.size() == 2);
+      REQUIRE(queue.inFlight() == 1);
+      REQUIRE_FALSE(queue.acknowledge(100));
+      REQUIRE(queue.acknowledge(102));
+      REQUIRE(publish(queue, 103) == 3);
+    }
+  }
+
+  WHEN("Messages in flight are not acknowledged")
+  {
+    for (uint8_t i = 0; i < 4; i++) {
+      enqueue(queue, i, 10);
+      publish(queue, i + 1);
+    }
+
+    THEN("They are kept and the queue stays full") {
+      REQUIRE(queue.full());
+      REQUIRE(queue.inFlight() == 4);
+      REQUIRE_FALSE(enqueue(queue, 4, 10));
+    }
+  }
+
+  WHEN("The connection is lost with messages in flight")
+  {
+    for (uint8_t i = 0; i < 4; i++) {
+      enqueue(queue, i, 10);
+      publish(queue, i + 1);
+    }
+    queue.acknowledge(1);
+    queue.requeueInFlight();
+
+    THEN("The unacknowledged messages are published again as duplicates, in order") {
+      REQUIRE(queue.size() == 3);
+      REQUIRE(queue.inFlight() == 0);
+
+      bool dup = false;
+      for (uint8_t i = 1; i < 4; i++) {
+        REQUIRE(publish(queue, 10 + i, &dup) == i);
+        REQUIRE(dup);
+      }
+      REQUIRE(publish(queue, 20) == -1);
+
+      /* The ids of the first publication are no longer valid */
+      REQUIRE_FALSE(queue.acknowledge(4));
+      REQUIRE(queue.acknowledge(13));
+      REQUIRE(queue.empty());
+    }
+  }
+
+  WHEN("Messages keep flowing through the queue")
+  {
+    THEN("Slots are reused") {
+      for (unsigned long i = 0; i < 1000; i++) {
+        REQUIRE(enqueue(queue, static_cast<uint8_t>(i), 10));
+        uint16_t const packet_id = static_cast<uint16_t>(i % UINT16_MAX) + 1;
+        REQUIRE(publish(queue, packet_id) == static_cast<uint8_t>(i));
+        REQUIRE(queue.acknowledge(packet_id));
+      }
+      REQUIRE(queue.empty());
+    }
+  }
+
+  WHEN("The queue is cleared")
+  {
+    enqueue(queue, 0, 10);
+    publish(queue, 1);
+    enqueue(queue, 1, 10);
+    queue.clear();
+
+    THEN("Nothing is left to publish") {
+      REQUIRE(queue.empty());
+      REQUIRE(publish(queue, 2) == -1);
+    }
+  }
+
+  WHEN("The slots are larger than the length of a message can be")
+  {
+    MqttOutboundQueue large;
+    large.begin(1, 70000);
+
+    THEN("The slot size is clamped") {
+      REQUIRE(large.slotSize() == UINT16_MAX);
+      REQUIRE(large.reserve() != nullptr);
+      large.commit(UINT16_MAX + 1);
+      REQUIRE(large.empty());
+      large.commit(UINT16_MAX);
+      REQUIRE(large.size() == 1);
+    }
+  }
+}
@@ -0,0 +1,153 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include <utility/mqtt/MqttPacketIdParser.h>
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Append the variable length encoding of a packet remaining length */
+static void remainingLength(std::vector<uint8_t> & stream, size_t const length)
+{
+  size_t remaining = length;
+  do {
+    uint8_t b = remaining & 0x7F;
+    remaining >>= 7;
+    if (remaining > 0)
+      b |= 0x80;
+    stream.push_back(b);
+  } while (remaining > 0);
+}
+
+/* Append a packet of the given type with a body of length bytes to stream */
+static void packet(std::vector<uint8_t> & stream, uint8_t const type, size_t const length)
+{
+  stream.push_back(type);
+  remainingLength(stream, length);
+  /* PUBACK (0x40) bytes in the bodies must not be mistaken for packets */
+  stream.insert(stream.end(), length, 0x40);
+}
+
+static void puback(std::vector<uint8_t> & stream, uint16_t const packet_id)
+{
+  stream.push_back(0x40);
+  stream.push_back(0x02);
+  stream.push_back(packet_id >> 8);
+  stream.push_back(packet_id & 0xFF);
+}
+
+/* Append a PUBLISH of a payload of length bytes with the given QoS, the packet id is only present with QoS 1 or 2 */
+static void publish(std::vector<uint8_t> & stream, uint8_t const qos, uint16_t const packet_id, size_t const topic_length, size_t const length)
+{
+  size_t const id_length = (qos > 0) ? 2 : 0;
+  stream.push_back(0x30 | (qos << 1));
+  remainingLength(stream, 2 + topic_length + id_length + length);
+  stream.push_back(topic_length >> 8);
+  stream.push_back(topic_length & 0xFF);
+  stream.insert(stream.end(), topic_length, 't');
+  if (qos > 0) {
+    stream.push_back(packet_id >> 8);
+    stream.push_back(packet_id & 0xFF);
+  }
+  stream.insert(stream.end(), length, 0x40);
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("The packet ids of the PUBACKs are read from the stream received from the broker", "[MqttPacketIdParser]")
+{
+  std::vector<uint16_t> ids;
+  MqttPacketIdParser parser(MqttPacketIdParser::PacketType::PubAck, [&ids](uint16_t const packet_id) { ids.push_back(packet_id); });
+  std::vector<uint8_t> stream;
+
+  packet(stream, 0x20, 2);   /* CONNACK */
+  puback(stream, 0x0102);
+  packet(stream, 0x30, 200); /* PUBLISH with a two byte remaining length */
+  puback(stream, 0x0040);
+  packet(stream, 0xD0, 0);   /* PINGRESP */
+  packet(stream, 0x30, 20000);
+  puback(stream, 0xFFFF);
+
+  std::vector<uint16_t> const expected{0x0102, 0x0040, 0xFFFF};
+
+  WHEN("The stream is received at once")
+  {
+    parser.feed(stream.data(), stream.size());
+
+    THEN("Only the ids of the PUBACKs are reported, in order") {
+      REQUIRE(ids == expected);
+    }
+  }
+
+  WHEN("The stream is received byte by byte")
+  {
+    for (uint8_t const b : stream)
+      parser.feed(&b, 1);
+
+    THEN("Only the ids of the PUBACKs are reported, in order") {
+      REQUIRE(ids == expected);
+    }
+  }
+
+  WHEN("The connection is reset in the middle of a packet")
+  {
+    parser.feed(stream.data(), 10);
+    ids.clear();
+    parser.reset();
+    std::vector<uint8_t> next;
+    puback(next, 7);
+    parser.feed(next.data(), next.size());
+
+    THEN("The new stream is parsed from its start") {
+      REQUIRE(ids == std::vector<uint16_t>{7});
+    }
+  }
+}
+
+SCENARIO("The packet ids of the QoS 1 PUBLISHes are read from the stream sent to the broker", "[MqttPacketIdParser]")
+{
+  std::vector<uint16_t> ids;
+  MqttPacketIdParser parser(MqttPacketIdParser::PacketType::Publish, [&ids](uint16_t const packet_id) { ids.push_back(packet_id); });
+  std::vector<uint8_t> stream;
+
+  packet(stream, 0x10, 30);  /* CONNECT */
+  publish(stream, 1, 0x0001, 20, 100);
+  publish(stream, 0, 0, 20, 100);
+  packet(stream, 0x82, 10);  /* SUBSCRIBE, has a packet id too */
+  publish(stream, 1, 0x0203, 300, 20000);
+  puback(stream, 0x0005);
+  publish(stream, 1, 0x0004, 0, 0);
+
+  std::vector<uint16_t> const expected{0x0001, 0x0203, 0x0004};
+
+  WHEN("The stream is sent at once")
+  {
+    parser.feed(stream.data(), stream.size());
+
+    THEN("Only the ids of the QoS 1 PUBLISHes are reported, in order") {
+      REQUIRE(ids == expected);
+    }
+  }
+
+  WHEN("The stream is sent byte by byte")
+  {
+    for (uint8_t const b : stream)
+      parser.feed(&b, 1);
+
+    THEN("Only the ids of the QoS 1 PUBLISHes are reported, in order") {
+      REQUIRE(ids == expected);
+    }
+  }
+}
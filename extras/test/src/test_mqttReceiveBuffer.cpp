@@ -0,0 +1,186 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+#include <CBORDecoder.h>
+#include <PropertyContainer.h>
+#include <utility/mqtt/MqttReceiveBuffer.h>
+
+/**************************************************************************************
+   TEST HELPER CLASSES
+ **************************************************************************************/
+
+/* Provides the payloads of the queued messages like MqttClient does from within its
+ * message callback, handing out at most max_chunk bytes per read like a network client.
+ */
+class MockMqttClient
+{
+public:
+  MockMqttClient(size_t const max_chunk) : _max_chunk{max_chunk}, _read_calls{0} { }
+
+  void push(std::vector<uint8_t> const & message) {
+    _data.insert(_data.end(), message.begin(), message.end());
+  }
+
+  int read(uint8_t * buf, size_t size) {
+    _read_calls++;
+    if (_data.empty())
+      return -1;
+    size_t const n = std::min(std::min(size, _max_chunk), _data.size());
+    std::copy(_data.begin(), _data.begin() + n, buf);
+    _data.erase(_data.begin(), _data.begin() + n);
+    return static_cast<int>(n);
+  }
+
+  inline size_t available() const { return _data.size(); }
+  inline size_t readCalls() const { return _read_calls; }
+
+private:
+  size_t _max_chunk;
+  size_t _read_calls;
+  std::vector<uint8_t> _data;
+};
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+static std::vector<uint8_t> message(size_t const length)
+{
+  std::vector<uint8_t> msg(length);
+  for (size_t i = 0; i < length; i++)
+    msg[i] = static_cast<uint8_t>(i * 7 + length);
+  return msg;
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Inbound MQTT messages are read into a bounded buffer", "[MqttReceiveBuffer]")
+{
+  size_t const buffer_size = 512;
+
+  MqttReceiveBuffer rx_buf;
+  rx_buf.begin(buffer_size);
+  MockMqttClient client(64);
+
+  WHEN("Messages of increasing size are received")
+  {
+    THEN("Messages up to the buffer size are read completely, larger ones are dropped and counted") {
+      unsigned long dropped = 0;
+      for (size_t length = 0; length <= 4 * buffer_size; length += 31)
+      {
+        std::vector<uint8_t> const msg = message(length);
+        client.push(msg);
+
+        bool const fits = (length <= buffer_size);
+        REQUIRE(rx_buf.read(client, length) == fits);
+        REQUIRE(client.available() == 0);
+
+        if (fits) {
+          REQUIRE(rx_buf.length() == length);
+          REQUIRE(std::vector<uint8_t>(rx_buf.data(), rx_buf.data() + rx_buf.length()) == msg);
+        } else {
+          dropped++;
+          REQUIRE(rx_buf.length() == 0);
+        }
+        REQUIRE(rx_buf.droppedMessages() == dropped);
+      }
+    }
+  }
+
+  WHEN("A message is read")
+  {
+    client.push(message(buffer_size));
+    rx_buf.read(client, buffer_size);
+
+    THEN("It is read in bulk, not byte by byte") {
+      REQUIRE(client.readCalls() == buffer_size / 64);
+    }
+  }
+
+  WHEN("A message ends before its announced length")
+  {
+    client.push(message(100));
+
+    THEN("It is dropped") {
+      REQUIRE_FALSE(rx_buf.read(client, 200));
+      REQUIRE(rx_buf.length() == 0);
+      REQUIRE(rx_buf.droppedMessages() == 1);
+    }
+  }
+
+  WHEN("A message follows a dropped one")
+  {
+    client.push(message(buffer_size + 1));
+    client.push(message(10));
+
+    THEN("It is read correctly") {
+      REQUIRE_FALSE(rx_buf.read(client, buffer_size + 1));
+      REQUIRE(rx_buf.read(client, 10));
+      REQUIRE(std::vector<uint8_t>(rx_buf.data(), rx_buf.data() + rx_buf.length()) == message(10));
+    }
+  }
+
+  WHEN("A message larger than the buffer is received and one-off allocations are allowed")
+  {
+    MqttReceiveBuffer big_rx_buf;
+    big_rx_buf.begin(buffer_size, 4 * buffer_size);
+    client.push(message(3 * buffer_size));
+    client.push(message(4 * buffer_size + 1));
+    client.push(message(10));
+
+    THEN("Messages up to the maximum length are read, larger ones are dropped") {
+      REQUIRE(big_rx_buf.read(client, 3 * buffer_size));
+      REQUIRE(std::vector<uint8_t>(big_rx_buf.data(), big_rx_buf.data() + big_rx_buf.length()) == message(3 * buffer_size));
+      big_rx_buf.release();
+      REQUIRE_FALSE(big_rx_buf.read(client, 4 * buffer_size + 1));
+      REQUIRE(client.available() == 10);
+      REQUIRE(big_rx_buf.droppedMessages() == 1);
+      REQUIRE(big_rx_buf.read(client, 10));
+      REQUIRE(std::vector<uint8_t>(big_rx_buf.data(), big_rx_buf.data() + big_rx_buf.length()) == message(10));
+    }
+  }
+
+  WHEN("The buffer has not been allocated")
+  {
+    MqttReceiveBuffer unallocated;
+    client.push(message(100));
+
+    THEN("Every message is drained and dropped") {
+      REQUIRE_FALSE(unallocated.read(client, 100));
+      REQUIRE(client.available() == 0);
+      REQUIRE(unallocated.droppedMessages() == 1);
+    }
+  }
+
+  WHEN("A property message is received")
+  {
+    PropertyContainer cloud_container, property_container;
+    CloudInt cloud_int = 42;
+    CloudInt int_test = 0;
+    addPropertyToContainer(cloud_container, cloud_int, "test", Permission::ReadWrite).publishOnDemand();
+    addPropertyToContainer(property_container, int_test, "test", Permission::ReadWrite);
+
+    cloud_int.requestUpdate();
+    std::vector<uint8_t> const payload = cbor::encode(cloud_container);
+    client.push(payload);
+
+    THEN("It is decoded straight from the buffer") {
+      REQUIRE(rx_buf.read(client, payload.size()));
+      CBORDecoder::decode(property_container, rx_buf.data(), rx_buf.length());
+      REQUIRE(int_test == 42);
+    }
+  }
+}
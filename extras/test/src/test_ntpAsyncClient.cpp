@@ -0,0 +1,190 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <NTPAsyncClient.h>
+
+/**************************************************************************************
+   TEST HELPER CLASSES
+ **************************************************************************************/
+
+/* Answers every request sent to a reachable server response_delay_ms after it was sent */
+class MockUDP : public UDP
+{
+public:
+  MockUDP(unsigned long const response_delay_ms)
+  : response_delay_ms{response_delay_ms}
+  , epoch{1633305600}
+  , corrupt{false}
+  , is_open{false}
+  , _answer_due{false}
+  , _answer_at_ms{0}
+  { }
+
+  unsigned long response_delay_ms;
+  unsigned long epoch;
+  bool corrupt;
+  bool is_open;
+  std::set<std::string> unreachable;
+  std::vector<std::string> servers;
+  std::vector<unsigned long> sent_at_ms;
+
+  virtual uint8_t begin(uint16_t) override { is_open = true; return 1; }
+  virtual void    stop() override { is_open = false; }
+  virtual int     beginPacket(const char * host, uint16_t) override { _host = host; return 1; }
+  virtual size_t  write(const uint8_t *, size_t size) override { return size; }
+
+  virtual int endPacket() override {
+    servers.push_back(_host);
+    sent_at_ms.push_back(millis());
+    if (unreachable.count(_host) == 0) {
+      _answer_due = true;
+      _answer_at_ms = millis() + response_delay_ms;
+    }
+    return 1;
+  }
+
+  virtual int parsePacket() override {
+    return (_answer_due && millis() >= _answer_at_ms) ? 48 : 0;
+  }
+
+  virtual int read(unsigned char * buffer, size_t len) override {
+    unsigned long const secs_since_1900 = corrupt ? 0 : (epoch + 2208988800UL);
+    for (size_t i = 0; i < len; i++)
+      buffer[i] = 0;
+    buffer[40] = (secs_since_1900 >> 24) & 0xFF;
+    buffer[41] = (secs_since_1900 >> 16) & 0xFF;
+    buffer[42] = (secs_since_1900 >>  8) & 0xFF;
+    buffer[43] = (secs_since_1900 >>  0) & 0xFF;
+    _answer_due = false;
+    return static_cast<int>(len);
+  }
+
+private:
+  std::string _host;
+  bool _answer_due;
+  unsigned long _answer_at_ms;
+};
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+/* Poll every ms from now until the request is over, return its outcome */
+static NTPAsyncClient::Status pollUntilDone(NTPAsyncClient & client, UDP & udp, unsigned long & time)
+{
+  NTPAsyncClient::Status status = NTPAsyncClient::Status::Pending;
+  for (unsigned long now = millis(); status == NTPAsyncClient::Status::Pending; now++) {
+    set_millis(now);
+    status = client.poll(udp, time);
+  }
+  return status;
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Network time is requested without waiting for the answer", "[NTPAsyncClient]")
+{
+  set_millis(10000);
+  NTPAsyncClient client;
+  unsigned long time = 0;
+
+  WHEN("The server answers after a while")
+  {
+    MockUDP udp(300);
+
+    THEN("poll() returns immediately until the answer arrives") {
+      REQUIRE(client.poll(udp, time) == NTPAsyncClient::Status::Pending);
+      REQUIRE(client.isPending());
+      REQUIRE(udp.is_open);
+      REQUIRE(udp.servers == std::vector<std::string>{"time.arduino.cc"});
+
+      set_millis(10299);
+      REQUIRE(client.poll(udp, time) == NTPAsyncClient::Status::Pending);
+      set_millis(10300);
+      REQUIRE(client.poll(udp, time) == NTPAsyncClient::Status::Done);
+      REQUIRE(time == 1633305600);
+      REQUIRE_FALSE(client.isPending());
+      REQUIRE_FALSE(udp.is_open);
+      REQUIRE(udp.servers.size() == 1);
+    }
+  }
+
+  WHEN("The first server does not answer")
+  {
+    MockUDP udp(100);
+    udp.unreachable.insert("time.arduino.cc");
+
+    THEN("The request is retried on the next server after a delay") {
+      REQUIRE(pollUntilDone(client, udp, time) == NTPAsyncClient::Status::Done);
+      REQUIRE(time == 1633305600);
+      REQUIRE(udp.servers == std::vector<std::string>{"time.arduino.cc", "pool.ntp.org"});
+      REQUIRE(udp.sent_at_ms[1] - udp.sent_at_ms[0] == NTPAsyncClient::NTP_TIMEOUT_MS + NTPAsyncClient::NTP_RETRY_DELAY_MS);
+    }
+  }
+
+  WHEN("No server answers")
+  {
+    MockUDP udp(100);
+    udp.unreachable = {"time.arduino.cc", "pool.ntp.org", "time.google.com"};
+
+    THEN("Every server is tried in turn, waiting longer before each retry, then the request fails") {
+      REQUIRE(pollUntilDone(client, udp, time) == NTPAsyncClient::Status::Failed);
+      REQUIRE_FALSE(udp.is_open);
+      REQUIRE(udp.servers == std::vector<std::string>{"time.arduino.cc", "pool.ntp.org", "time.google.com",
+                                                      "time.arduino.cc", "pool.ntp.org", "time.google.com"});
+      std::vector<unsigned long> const retry_delays = {500, 1000, 2000, 4000, 4000};
+      for (size_t i = 1; i < udp.sent_at_ms.size(); i++) {
+        REQUIRE(udp.sent_at_ms[i] - udp.sent_at_ms[i - 1] == NTPAsyncClient::NTP_TIMEOUT_MS + retry_delays[i - 1]);
+      }
+    }
+
+    THEN("The next poll() starts a new request") {
+      REQUIRE(pollUntilDone(client, udp, time) == NTPAsyncClient::Status::Failed);
+      udp.unreachable.clear();
+      REQUIRE(pollUntilDone(client, udp, time) == NTPAsyncClient::Status::Done);
+      REQUIRE(udp.servers.back() == "time.arduino.cc");
+    }
+  }
+
+  WHEN("The answer is corrupted")
+  {
+    MockUDP udp(100);
+    udp.corrupt = true;
+
+    THEN("It is retried like an unanswered request") {
+      REQUIRE(client.poll(udp, time) == NTPAsyncClient::Status::Pending);
+      set_millis(10100);
+      REQUIRE(client.poll(udp, time) == NTPAsyncClient::Status::Pending);
+      REQUIRE(client.isPending());
+      udp.corrupt = false;
+      REQUIRE(pollUntilDone(client, udp, time) == NTPAsyncClient::Status::Done);
+      REQUIRE(udp.servers.size() == 2);
+    }
+  }
+
+  WHEN("The request is abandoned")
+  {
+    MockUDP udp(100);
+    client.poll(udp, time);
+    client.stop(udp);
+
+    THEN("The socket is closed") {
+      REQUIRE_FALSE(client.isPending());
+      REQUIRE_FALSE(udp.is_open);
+    }
+  }
+}
@@ -0,0 +1,289 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdio.h>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+#include <CBOREncoder.h>
+#include <PropertyContainer.h>
+#include <utility/store/OfflineRamStore.h>
+#include <utility/store/OfflineFileStore.h>
+
+/**************************************************************************************
+   CONSTANTS
+ **************************************************************************************/
+
+static char const OFFLINE_STORE_FILE[] = "testOfflineStore.bin";
+
+/**************************************************************************************
+   TEST HELPER FUNCTIONS
+ **************************************************************************************/
+
+static std::vector<uint8_t> record(uint8_t const value, size_t const length)
+{
+  return std::vector<uint8_t>(length, value);
+}
+
+static bool push(OfflineStore & store, std::vector<uint8_t> const & rec)
+{
+  return store.push(rec.data(), rec.size());
+}
+
+/* Return the oldest records that fit into size bytes, back to back */
+static std::vector<uint8_t> peek(OfflineStore & store, size_t const size, size_t & count)
+{
+  std::vector<uint8_t> buf(size);
+  buf.resize(store.peek(buf.data(), buf.size(), count));
+  return buf;
+}
+
+static long fileSize(char const * path)
+{
+  FILE * file = fopen(path, "rb");
+  if (file == nullptr)
+    return -1;
+  fseek(file, 0, SEEK_END);
+  long const size = ftell(file);
+  fclose(file);
+  return size;
+}
+
+static std::vector<uint8_t> concat(std::vector<std::vector<uint8_t>> const & records)
+{
+  std::vector<uint8_t> out;
+  for (std::vector<uint8_t> const & rec : records)
+    out.insert(out.end(), rec.begin(), rec.end());
+  return out;
+}
+
+/* Behaviour shared by every backend, store holds 100 bytes of records and their headers */
+static void requireFifoBehaviour(OfflineStore & store)
+{
+  size_t count = 0;
+
+  REQUIRE(store.begin());
+  REQUIRE(store.empty());
+  REQUIRE(peek(store, 64, count).empty());
+  REQUIRE(count == 0);
+
+  /* Records are returned oldest first and stay until removed */
+  REQUIRE(push(store, record(1, 10)));
+  REQUIRE(push(store, record(2, 20)));
+  REQUIRE(push(store, record(3, 30)));
+  REQUIRE(store.count() == 3);
+  REQUIRE(peek(store, 64, count) == concat({record(1, 10), record(2, 20), record(3, 30)}));
+  REQUIRE(count == 3);
+  REQUIRE(peek(store, 59, count) == concat({record(1, 10), record(2, 20)}));
+  REQUIRE(count == 2);
+  REQUIRE(store.count() == 3);
+
+  /* Records that do not fit are dropped and counted */
+  REQUIRE(store.freeSpace() == 100 - 66 - 2);
+  REQUIRE_FALSE(push(store, record(4, 40)));
+  REQUIRE(store.droppedRecords() == 1);
+  REQUIRE_FALSE(store.push(nullptr, 0));
+
+  store.pop(2);
+  REQUIRE(store.count() == 1);
+  REQUIRE(peek(store, 64, count) == record(3, 30));
+
+  REQUIRE(push(store, record(4, 40)));
+  REQUIRE(peek(store, 100, count) == concat({record(3, 30), record(4, 40)}));
+  REQUIRE(count == 2);
+
+  store.clear();
+  REQUIRE(store.empty());
+  REQUIRE(push(store, record(5, 96)));
+  REQUIRE(peek(store, 100, count) == record(5, 96));
+  store.pop(1);
+  REQUIRE(store.empty());
+}
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Property updates are stored while offline", "[OfflineStore]")
+{
+  WHEN("The RAM backend is used")
+  {
+    OfflineRamStore store(100);
+
+    THEN("Records are kept first in first out") {
+      requireFifoBehaviour(store);
+    }
+
+    THEN("Records wrap around the end of the ring") {
+      REQUIRE(store.begin());
+      size_t count = 0;
+      for (uint8_t i = 0; i < 50; i++) {
+        REQUIRE(push(store, record(i, 7 + i % 5)));
+        REQUIRE(push(store, record(i + 100, 11)));
+        REQUIRE(peek(store, 100, count) == concat({record(i, 7 + i % 5), record(i + 100, 11)}));
+        store.pop(2);
+      }
+      REQUIRE(store.empty());
+    }
+
+    THEN("Nothing is stored before begin()") {
+      OfflineRamStore unallocated(100);
+      REQUIRE_FALSE(push(unallocated, record(1, 10)));
+      REQUIRE(unallocated.droppedRecords() == 1);
+    }
+  }
+
+  WHEN("The file backend is used")
+  {
+    remove(OFFLINE_STORE_FILE);
+
+    THEN("Records are kept first in first out") {
+      OfflineFileStore store(OFFLINE_STORE_FILE, 100);
+      requireFifoBehaviour(store);
+    }
+
+    THEN("Records survive a reset") {
+      {
+        OfflineFileStore store(OFFLINE_STORE_FILE, 1024);
+        REQUIRE(store.begin());
+        REQUIRE(push(store, record(1, 10)));
+        REQUIRE(push(store, record(2, 20)));
+        REQUIRE(push(store, record(3, 30)));
+        store.pop(1);
+      }
+      OfflineFileStore store(OFFLINE_STORE_FILE, 1024);
+      REQUIRE(store.begin());
+      size_t count = 0;
+      REQUIRE(store.count() == 2);
+      REQUIRE(peek(store, 1024, count) == concat({record(2, 20), record(3, 30)}));
+    }
+
+    THEN("A record cut short by a reset is discarded") {
+      {
+        OfflineFileStore store(OFFLINE_STORE_FILE, 1024);
+        REQUIRE(store.begin());
+        REQUIRE(push(store, record(1, 10)));
+        REQUIRE(push(store, record(2, 20)));
+      }
+      /* Header of a third record of 30 bytes, with only 5 of them written */
+      FILE * file = fopen(OFFLINE_STORE_FILE, "ab");
+      uint8_t const partial[] = {30, 0, 3, 3, 3, 3, 3};
+      fwrite(partial, 1, sizeof(partial), file);
+      fclose(file);
+
+      OfflineFileStore store(OFFLINE_STORE_FILE, 1024);
+      REQUIRE(store.begin());
+      REQUIRE(store.count() == 2);
+      REQUIRE(push(store, record(4, 40)));
+      size_t count = 0;
+      REQUIRE(peek(store, 1024, count) == concat({record(1, 10), record(2, 20), record(4, 40)}));
+    }
+
+    THEN("The leftovers of a record cut short are not read back after a shorter record") {
+      {
+        OfflineFileStore store(OFFLINE_STORE_FILE, 1024);
+        REQUIRE(store.begin());
+        REQUIRE(push(store, record(1, 10)));
+      }
+      /* Header of a record of 30 bytes, its first bytes look like the header of a record of 2 bytes */
+      FILE * file = fopen(OFFLINE_STORE_FILE, "ab");
+      uint8_t const partial[] = {30, 0, 3, 2, 0, 9, 9};
+      fwrite(partial, 1, sizeof(partial), file);
+      fclose(file);
+
+      {
+        OfflineFileStore store(OFFLINE_STORE_FILE, 1024);
+        REQUIRE(store.begin());
+        REQUIRE(push(store, record(4, 1)));
+      }
+      OfflineFileStore store(OFFLINE_STORE_FILE, 1024);
+      REQUIRE(store.begin());
+      REQUIRE(store.count() == 2);
+      size_t count = 0;
+      REQUIRE(peek(store, 1024, count) == concat({record(1, 10), record(4, 1)}));
+    }
+
+    THEN("The file does not grow while records keep flowing through the store") {
+      size_t count = 0;
+      {
+        OfflineFileStore store(OFFLINE_STORE_FILE, 100);
+        REQUIRE(store.begin());
+        REQUIRE(push(store, record(0, 20)));
+        for (uint8_t i = 1; i < 100; i++) {
+          REQUIRE(push(store, record(i, 10 + i % 20)));
+          store.pop(1);
+          REQUIRE(peek(store, 100, count) == record(i, 10 + i % 20));
+          REQUIRE(fileSize(OFFLINE_STORE_FILE) <= 4 + 2 * 100);
+        }
+      }
+      OfflineFileStore store(OFFLINE_STORE_FILE, 100);
+      REQUIRE(store.begin());
+      REQUIRE(store.count() == 1);
+      REQUIRE(peek(store, 100, count) == record(99, 29));
+    }
+
+    remove(OFFLINE_STORE_FILE);
+  }
+
+  WHEN("Timestamped samples of a property are stored and batched into one message")
+  {
+    PropertyContainer property_container;
+    CloudInt sample;
+    addPropertyToContainer(property_container, sample, "energy", Permission::Read).publishOnChange(0.0f, 0).encodeTimestamp();
+
+    /* The same samples published one message at a time, as if online */
+    PropertyContainer online_property_container;
+    CloudInt online_sample;
+    addPropertyToContainer(online_property_container, online_sample, "energy", Permission::Read).publishOnChange(0.0f, 0).encodeTimestamp();
+
+    OfflineRamStore store(256);
+    REQUIRE(store.begin());
+
+    std::vector<uint8_t> expected = {0x9F};
+    for (int i = 0; i < 5; i++) {
+      sample = 1000 + i;
+      sample.setTimestamp(1633305600 + 60 * i);
+      uint8_t buf[64];
+      size_t bytes_encoded = 0;
+      REQUIRE(CBOREncoder::encodeRecords(sample, buf, sizeof(buf), bytes_encoded) == CborNoError);
+      sample.appendCompleted();
+      REQUIRE(store.push(buf, bytes_encoded));
+
+      online_sample = 1000 + i;
+      online_sample.setTimestamp(1633305600 + 60 * i);
+      std::vector<uint8_t> const message = cbor::encode(online_property_container);
+      REQUIRE(message.size() > 2);
+      expected.insert(expected.end(), message.begin() + 1, message.end() - 1);
+    }
+    expected.push_back(0xFF);
+
+    THEN("A sample which does not fit into the store stays pending") {
+      sample = 2000;
+      sample.setTimestamp(1633305600 + 600);
+      REQUIRE(push(store, record(0, store.freeSpace() - 4)));
+      REQUIRE(store.freeSpace() == 2);
+      std::vector<uint8_t> buf(store.freeSpace() + 1);
+      size_t bytes_encoded = 0;
+      REQUIRE(CBOREncoder::encodeRecords(sample, buf.data(), buf.size(), bytes_encoded) != CborNoError);
+      REQUIRE(sample.shouldBeUpdated());
+      REQUIRE(sample.isDifferentFromCloud());
+    }
+
+    THEN("The batch holds every sample, oldest first") {
+      size_t count = 0;
+      std::vector<uint8_t> batch = {0x9F};
+      std::vector<uint8_t> const records = peek(store, 256, count);
+      batch.insert(batch.end(), records.begin(), records.end());
+      batch.push_back(0xFF);
+      REQUIRE(count == 5);
+      REQUIRE(batch == expected);
+    }
+  }
+}
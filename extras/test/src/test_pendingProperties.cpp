@@ -0,0 +1,237 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+
+#include <CBOREncoder.h>
+#include <property/types/CloudWrapperInt.h>
+#include <property/types/automation/CloudDimmedLight.h>
+
+/**************************************************************************************
+   TEST HELPER CLASSES
+ **************************************************************************************/
+
+/* Property type defined by a sketch, its value is changed without calling updateLocalTimestamp() */
+class UserDefinedInt : public Property
+{
+public:
+  int value = 0;
+  int cloud_value = 0;
+
+  virtual bool isDifferentFromCloud() { return value != cloud_value; }
+  virtual void fromCloudToLocal() { value = cloud_value; }
+  virtual void fromLocalToCloud() { cloud_value = value; }
+  virtual CborError appendAttributesToCloud(CborEncoder *encoder) { return appendAttribute(value, "", encoder); }
+  virtual void setAttributesFromCloud() { setAttribute(cloud_value, ""); }
+};
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("Only pending properties are visited by the encoder", "[ArduinoCloudThing::pending]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+
+  CloudInt   int_test   = 0;
+  CloudFloat float_test = 0.0f;
+  CloudBool  bool_test  = false;
+
+  addPropertyToContainer(property_container, int_test, "int_test", Permission::ReadWrite);
+  addPropertyToContainer(property_container, float_test, "float_test", Permission::ReadWrite);
+  addPropertyToContainer(property_container, bool_test, "bool_test", Permission::ReadWrite);
+
+  WHEN("The properties have just been added")
+  {
+    THEN("All of them are pending") {
+      REQUIRE(property_container.nextPending(0) == 0);
+      REQUIRE(property_container.nextPending(1) == 1);
+      REQUIRE(property_container.nextPending(2) == 2);
+    }
+  }
+
+  WHEN("All properties have been sent to the cloud")
+  {
+    REQUIRE(cbor::encode(property_container).size() != 0);
+    REQUIRE(cbor::encode(property_container).size() == 0);
+
+    THEN("No property is pending") {
+      REQUIRE(property_container.nextPending(0) == property_container.size());
+    }
+
+    WHEN("A property is changed locally")
+    {
+      set_millis(1000);
+      float_test = 3.0f;
+
+      THEN("Only that property is pending") {
+        REQUIRE(property_container.nextPending(0) == 1);
+        REQUIRE(property_container.nextPending(2) == property_container.size());
+      }
+
+      THEN("It is sent and is no longer pending afterwards") {
+        REQUIRE(cbor::encode(property_container).size() != 0);
+        REQUIRE(cbor::encode(property_container).size() == 0);
+        REQUIRE(property_container.nextPending(0) == property_container.size());
+      }
+    }
+
+    WHEN("An update is requested for a property")
+    {
+      int_test.requestUpdate();
+
+      THEN("That property is pending") {
+        REQUIRE(property_container.nextPending(0) == 0);
+        REQUIRE(property_container.nextPending(1) == property_container.size());
+      }
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("Wrapped properties are always polled", "[ArduinoCloudThing::pending]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+
+  CloudInt int_test = 0;
+  int wrapped_int = 0;
+  CloudWrapperInt wrapped_test(wrapped_int);
+
+  addPropertyToContainer(property_container, int_test, "int_test", Permission::ReadWrite);
+  addPropertyToContainer(property_container, wrapped_test, "wrapped_test", Permission::ReadWrite);
+
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  THEN("Only the polled properties are visited") {
+    REQUIRE(property_container.nextPending(0) == 1);
+    REQUIRE(property_container.nextPolled(0) == 1);
+    REQUIRE_FALSE(property_container.hasPending());
+  }
+
+  WHEN("Both properties are marked pending")
+  {
+    int_test = 3;
+    wrapped_test.requestUpdate();
+
+    THEN("They are visited as marked, the polled one only while it is marked") {
+      REQUIRE(property_container.nextMarked(0) == 0);
+      REQUIRE(property_container.nextMarked(1) == 1);
+      property_container.clearPending(1);
+      REQUIRE(property_container.nextMarked(1) == property_container.size());
+      REQUIRE(property_container.nextPending(1) == 1);
+    }
+  }
+
+  WHEN("The wrapped variable is changed without notice")
+  {
+    set_millis(500);
+    wrapped_int = 7;
+
+    THEN("The change is still sent to the cloud") {
+      REQUIRE(cbor::encode(property_container).size() != 0);
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("User defined properties are always polled", "[ArduinoCloudThing::pending]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+
+  CloudInt int_test = 0;
+  UserDefinedInt user_test;
+
+  addPropertyToContainer(property_container, int_test, "int_test", Permission::ReadWrite);
+  addPropertyToContainer(property_container, user_test, "user_test", Permission::ReadWrite);
+
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  THEN("Only the user defined property is polled") {
+    REQUIRE(property_container.nextPolled(0) == 1);
+  }
+
+  WHEN("Its value is changed without notice")
+  {
+    set_millis(500);
+    user_test.value = 7;
+
+    THEN("The change is still sent to the cloud") {
+      REQUIRE(cbor::encode(property_container).size() != 0);
+      REQUIRE(user_test.cloud_value == 7);
+    }
+  }
+}
+
+/**************************************************************************************/
+
+SCENARIO("A DimmedLight property changed with its setters is sent to the cloud", "[ArduinoCloudThing::pending]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+  CloudDimmedLight light_test = CloudDimmedLight(false, 0.0f);
+  addPropertyToContainer(property_container, light_test, "light_test", Permission::ReadWrite);
+
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  set_millis(1000);
+  light_test.setBrightness(50.0f);
+  REQUIRE(cbor::encode(property_container).size() != 0);
+
+  set_millis(2000);
+  light_test.setSwitch(true);
+  REQUIRE(cbor::encode(property_container).size() != 0);
+}
+
+/**************************************************************************************/
+
+SCENARIO("More properties than fit in a single bitset word are tracked", "[ArduinoCloudThing::pending]")
+{
+  set_millis(0);
+
+  PropertyContainer property_container;
+  std::vector<std::unique_ptr<CloudInt>> properties;
+
+  for (int i = 0; i < 100; i++) {
+    properties.emplace_back(new CloudInt(0));
+    addPropertyToContainer(property_container, *properties.back(), "property_" + std::to_string(i), Permission::ReadWrite);
+  }
+
+  unsigned int current_property_index = 0;
+  int bytes_encoded = 0;
+  uint8_t buf[256];
+  do {
+    CBOREncoder::encode(property_container, buf, sizeof(buf), bytes_encoded, current_property_index);
+  } while (bytes_encoded > 0);
+
+  REQUIRE(property_container.nextPending(0) == property_container.size());
+
+  set_millis(1000);
+  *properties[33] = 1;
+  *properties[97] = 1;
+
+  REQUIRE(property_container.nextPending(0) == 33);
+  REQUIRE(property_container.nextPending(34) == 97);
+  REQUIRE(property_container.nextPending(98) == property_container.size());
+}
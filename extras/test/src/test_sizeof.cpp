@@ -0,0 +1,71 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <PropertyContainer.h>
+#include <property/types/CloudBool.h>
+#include <property/types/CloudInt.h>
+#include <property/types/CloudUnsignedInt.h>
+#include <property/types/CloudFloat.h>
+#include <property/types/CloudString.h>
+#include <property/types/CloudLocation.h>
+#include <property/types/CloudColor.h>
+#include <property/types/CloudSchedule.h>
+#include <property/types/automation/CloudColoredLight.h>
+#include <property/types/automation/CloudDimmedLight.h>
+#include <property/types/automation/CloudTelevision.h>
+#include <property/types/automation/CloudLight.h>
+#include <property/types/automation/CloudSwitch.h>
+
+/**************************************************************************************
+   CONSTANTS
+ **************************************************************************************/
+
+/* Sizes measured on a 64 bit host before the Property members were packed */
+static size_t const PROPERTY_SIZE_BEFORE_PACKING = 176;
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+#define REPORT_SIZEOF(type, size_before)                                                \
+  do {                                                                                  \
+    INFO(#type ": " << sizeof(type) << " bytes, " << size_before << " before packing"); \
+    CHECK((sizeof(type) * 4) <= (size_before * 3));                                   \
+  } while(0)
+
+SCENARIO("Property objects are compact", "[Property::sizeof]")
+{
+  WHEN("Running on a 64 bit host")
+  {
+    if (sizeof(void *) != 8)
+      return;
+
+    THEN("sizeof(Property) is at least 30% smaller than before packing") {
+      INFO("Property: " << sizeof(Property) << " bytes, " << PROPERTY_SIZE_BEFORE_PACKING << " before packing");
+      REQUIRE((sizeof(Property) * 10) <= (PROPERTY_SIZE_BEFORE_PACKING * 7));
+    }
+
+    THEN("Every Cloud type is at least 25% smaller than before packing") {
+      REPORT_SIZEOF(CloudBool,         176);
+      REPORT_SIZEOF(CloudInt,          184);
+      REPORT_SIZEOF(CloudUnsignedInt,  184);
+      REPORT_SIZEOF(CloudFloat,        184);
+      REPORT_SIZEOF(CloudString,       240);
+      REPORT_SIZEOF(CloudLocation,     192);
+      REPORT_SIZEOF(CloudColor,        200);
+      REPORT_SIZEOF(CloudSchedule,     208);
+      REPORT_SIZEOF(CloudColoredLight, 232);
+      REPORT_SIZEOF(CloudDimmedLight,  192);
+      REPORT_SIZEOF(CloudTelevision,   224);
+      REPORT_SIZEOF(CloudLight,        176);
+      REPORT_SIZEOF(CloudSwitch,       176);
+    }
+  }
+}
@@ -0,0 +1,128 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <Arduino.h>
+#include <UTCMillisClock.h>
+
+/**************************************************************************************
+   CONSTANTS
+ **************************************************************************************/
+
+static unsigned long const EPOCH = 1633305600;
+static uint64_t const EPOCH_MS = 1633305600000ULL;
+static unsigned long const HOUR_MS = 60UL * 60UL * 1000UL;
+
+/**************************************************************************************
+   TEST CODE
+ **************************************************************************************/
+
+SCENARIO("UTC time is kept with millisecond resolution", "[UTCMillisClock]")
+{
+  set_millis(10000);
+  UTCMillisClock clock;
+
+  WHEN("The clock has never been synced")
+  {
+    THEN("There is no time") {
+      REQUIRE_FALSE(clock.isSynced());
+      REQUIRE(clock.getTimeMillis() == 0);
+    }
+  }
+
+  WHEN("The clock is synced")
+  {
+    clock.sync(EPOCH);
+
+    THEN("millis() elapsed since the sync are added to the sync time") {
+      REQUIRE(clock.isSynced());
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS);
+      set_millis(10001);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 1);
+      set_millis(10000 + 1234);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 1234);
+    }
+  }
+
+  WHEN("millis() wraps around")
+  {
+    set_millis(0xFFFFFF00UL);
+    clock.sync(EPOCH);
+
+    THEN("The time keeps increasing") {
+      set_millis(0xFFFFFFFFUL);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 0xFF);
+      set_millis(0x100);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 0x200);
+      set_millis(0x80000000UL);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 0x80000100ULL);
+      set_millis(0xFFFFFF00UL);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 0x100000000ULL);
+    }
+  }
+
+  WHEN("millis() runs 100 ppm slow between two syncs 24 hours apart")
+  {
+    clock.sync(EPOCH);
+    /* 24 hours of UTC are 8640 ms more than the millis() elapsed */
+    set_millis(10000 + 24 * HOUR_MS - 8640);
+    clock.sync(EPOCH + 24 * 60 * 60);
+
+    THEN("The drift is corrected until the next sync") {
+      REQUIRE(clock.driftPpm() == 100);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 24 * HOUR_MS);
+      set_millis(millis() + 10 * 1000);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 24 * HOUR_MS + 10001);
+      set_millis(millis() + HOUR_MS - 10 * 1000);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 25 * HOUR_MS + 360);
+    }
+  }
+
+  WHEN("millis() runs fast by more than the maximum drift")
+  {
+    clock.setMaxDrift(50);
+    clock.sync(EPOCH);
+    set_millis(10000 + 24 * HOUR_MS + 8640);
+    clock.sync(EPOCH + 24 * 60 * 60);
+
+    THEN("The correction is bounded") {
+      REQUIRE(clock.driftPpm() == -50);
+      set_millis(millis() + HOUR_MS);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 25 * HOUR_MS - 180);
+    }
+  }
+
+  WHEN("Two syncs are too close to measure the drift")
+  {
+    clock.sync(EPOCH);
+    set_millis(10000 + HOUR_MS - 1000);
+    clock.sync(EPOCH + 60 * 60);
+
+    THEN("No correction is applied") {
+      REQUIRE(clock.driftPpm() == 0);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + HOUR_MS);
+    }
+  }
+
+  WHEN("A sync would move the time backwards")
+  {
+    clock.sync(EPOCH);
+    set_millis(10000 + 1500);
+    REQUIRE(clock.getTimeMillis() == EPOCH_MS + 1500);
+    clock.sync(EPOCH + 1);
+
+    THEN("The time holds until UTC catches up") {
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 1500);
+      set_millis(10000 + 1500 + 400);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 1500);
+      set_millis(10000 + 1500 + 600);
+      REQUIRE(clock.getTimeMillis() == EPOCH_MS + 1600);
+    }
+  }
+}
@@ -0,0 +1,94 @@
+/*
+   Copyright (c) 2024 Arduino.  All rights reserved.
+*/
+
+/**************************************************************************************
+   INCLUDE
+ **************************************************************************************/
+
+#include <util/BenchUtil.h>
+
+#include <string>
+
+#include <CBOREncoder.h>
+
+/**************************************************************************************
+   NAMESPACE
+ **************************************************************************************/
+
+namespace bench
+{
+
+/**************************************************************************************
+   CONSTANTS
+ **************************************************************************************/
+
+static size_t const NUM_PROPERTY_TYPES = 7;
+static size_t const MAX_IDENTIFIERS = 255;
+/* Large enough for 1000 mixed properties in a single message */
+static size_t const MESSAGE_BUFFER_SIZE = 128 * 1024;
+
+/**************************************************************************************
+   CTOR/DTOR
+ **************************************************************************************/
+
+MixedPropertyContainer::MixedPropertyContainer(int const num_properties)
+: _message(MESSAGE_BUFFER_SIZE)
+, _has_identifiers{static_cast<size_t>(num_properties) <= MAX_IDENTIFIERS}
+{
+  for (int i = 0; i < num_properties; i++)
+  {
+    std::vector<char const *> attributes;
+    switch (i % NUM_PROPERTY_TYPES)
+    {
+      case 0: _properties.emplace_back(new CloudInt(i)); attributes = {""}; break;
+      case 1: _properties.emplace_back(new CloudFloat(i * 0.5f)); attributes = {""}; break;
+      case 2: _properties.emplace_back(new CloudBool(true)); attributes = {""}; break;
+      case 3: {
+        CloudString * str = new CloudString();
+        *str = "value_" + std::to_string(i);
+        _properties.emplace_back(str);
+        attributes = {""};
+      } break;
+      case 4: _properties.emplace_back(new CloudLocation(45.0f, 9.0f)); attributes = {"lat", "lon"}; break;
+      case 5: _properties.emplace_back(new CloudColoredLight(true, 2.0f, 2.0f, 2.0f)); attributes = {"swi", "hue", "sat", "bri"}; break;
+      default: _properties.emplace_back(new CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7)); attributes = {"swi", "vol", "mut", "pbc", "inp", "cha"}; break;
+    }
+
+    _names.push_back("property_" + std::to_string(i));
+    addPropertyToContainer(_container, *_properties.back(), _names.back(), Permission::ReadWrite, _has_identifiers ? (i + 1) : -1).publishOnDemand();
+
+    /* Every attribute gets a value of each kind, the property picks the one matching its type */
+    CborMapDataArena map_data_arena;
+    for (char const * attribute : attributes) {
+      CborMapData map_data;
+      map_data.attribute_name.set(attribute);
+      map_data.val.set(1.0);
+      map_data.str_val.set("update");
+      map_data.bool_val.set(false);
+      map_data_arena.add(map_data);
+    }
+    _map_data.push_back(map_data_arena);
+  }
+}
+
+/**************************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+size_t MixedPropertyContainer::encodeAll(bool const lightPayload)
+{
+  requestUpdateForAllProperties(_container);
+
+  int bytes_encoded = 0;
+  unsigned int current_property_index = 0;
+  if (CBOREncoder::encode(_container, _message.data(), _message.size(), bytes_encoded, current_property_index, lightPayload) != CborNoError)
+    return 0;
+  return (bytes_encoded > 0) ? static_cast<size_t>(bytes_encoded) : 0;
+}
+
+/**************************************************************************************
+   NAMESPACE
+ **************************************************************************************/
+
+} /* bench */
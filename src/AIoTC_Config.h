@@ -34,6 +34,49 @@
   #define NTP_USE_RANDOM_PORT     (1)
 #endif
 
+/* Default size of the buffers used to encode MQTT messages, see ArduinoIoTCloudTCP::setMqttTransmitBufferSize */
+#ifndef AIOT_CONFIG_MQTT_TRANSMIT_BUFFER_SIZE
+  #define AIOT_CONFIG_MQTT_TRANSMIT_BUFFER_SIZE   (256UL)
+#endif
+
+/* Default size of the buffer inbound MQTT messages are read into, see ArduinoIoTCloudTCP::setMqttReceiveBufferSize */
+#ifndef AIOT_CONFIG_MQTT_RECEIVE_BUFFER_SIZE
+  #if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_MBED)
+    #define AIOT_CONFIG_MQTT_RECEIVE_BUFFER_SIZE  (8192UL)
+  #else
+    #define AIOT_CONFIG_MQTT_RECEIVE_BUFFER_SIZE  (2048UL)
+  #endif
+#endif
+
+/* Largest inbound MQTT message read into a one-off allocation when it does not fit the receive buffer */
+#ifndef AIOT_CONFIG_MQTT_RECEIVE_MAX_MESSAGE_SIZE
+  #define AIOT_CONFIG_MQTT_RECEIVE_MAX_MESSAGE_SIZE (32768UL)
+#endif
+
+/* Worst case drift of the RTC, see TimeServiceClass::setMaxDrift */
+#ifndef AIOT_CONFIG_TIMESERVICE_MAX_DRIFT_ppm
+  #define AIOT_CONFIG_TIMESERVICE_MAX_DRIFT_ppm   (500UL)
+#endif
+
+/* Largest drift since the last time sync for which the RTC is trusted on reconnection, see TimeServiceClass::isTimeTrusted */
+#ifndef AIOT_CONFIG_TIMESERVICE_MAX_TRUSTED_DRIFT_ms
+  #define AIOT_CONFIG_TIMESERVICE_MAX_TRUSTED_DRIFT_ms (1000UL)
+#endif
+
+/* Default number of property messages kept until acknowledged, see ArduinoIoTCloudTCP::enableOutboundQueue */
+#ifndef AIOT_CONFIG_MQTT_OUTBOUND_QUEUE_DEPTH
+  #define AIOT_CONFIG_MQTT_OUTBOUND_QUEUE_DEPTH   (4UL)
+#endif
+
+/* Default budgets of a property burst, see ArduinoIoTCloudTCP::enablePropertyBurst */
+#ifndef AIOT_CONFIG_PROPERTY_BURST_MAX_BYTES
+  #define AIOT_CONFIG_PROPERTY_BURST_MAX_BYTES    (2048UL)
+#endif
+
+#ifndef AIOT_CONFIG_PROPERTY_BURST_MAX_TIME_ms
+  #define AIOT_CONFIG_PROPERTY_BURST_MAX_TIME_ms  (100UL)
+#endif
+
 #ifndef DEBUG_ERROR
   #define DEBUG_ERROR(fmt, ...) Debug.print(DBG_ERROR, fmt, ## __VA_ARGS__)
 #endif
@@ -57,6 +57,18 @@ bool ArduinoIoTCloudClass::setTimestamp(String const & prop_name, unsigned long
   return true;
 }
 
+bool ArduinoIoTCloudClass::setTimestampMillis(String const & prop_name, uint64_t const timestamp_ms)
+{
+  Property * p = getProperty(getThingPropertyContainer(), prop_name);
+
+  if (p == nullptr)
+    return false;
+
+  p->setTimestampMillis(timestamp_ms);
+
+  return true;
+}
+
 void ArduinoIoTCloudClass::addCallback(ArduinoIoTCloudEvent const event, OnCloudEventCallback callback)
 {
   _cloud_event_callback[static_cast<size_t>(event)] = callback;
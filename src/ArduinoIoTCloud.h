@@ -90,6 +90,7 @@ class ArduinoIoTCloudClass
 
             void push();
             bool setTimestamp(String const & prop_name, unsigned long const timestamp);
+            bool setTimestampMillis(String const & prop_name, uint64_t const timestamp_ms);
 
     inline void     setThingId (String const thing_id)  { _thing_id = thing_id; };
     inline String & getThingId ()                       { return _thing_id; };
@@ -99,7 +100,13 @@ class ArduinoIoTCloudClass
     inline ConnectionHandler * getConnection()          { return _connection; }
 
     inline unsigned long getInternalTime()              { return _time_service.getTime(); }
+    inline uint64_t      getInternalTimeMillis()        { return _time_service.getTimeMillis(); }
     inline unsigned long getLocalTime()                 { return _time_service.getLocalTime(); }
+    /* millis() timestamp of the next property due to be published, useful to sleep
+     * between update() calls. Changes to variables wrapped by addProperty(int &, ...)
+     * and the like are only detected by update() and are not taken into account.
+     */
+    inline unsigned long nextDeadlineMillis()           { return ::nextDeadlineMillis(getThingPropertyContainer(), millis()); }
 
     void addCallback(ArduinoIoTCloudEvent const event, OnCloudEventCallback callback);
 
@@ -51,6 +51,7 @@ ArduinoIoTCloudLPWAN::ArduinoIoTCloudLPWAN()
 , _retryEnable{false}
 , _maxNumRetry{5}
 , _intervalRetry{AIOT_CONFIG_LPWAN_UPDATE_RETRY_DELAY_ms}
+, _shortestFloatEnable{false}
 , _thing_property_container()
 , _last_checked_property_index{0}
 {
@@ -151,7 +152,7 @@ void ArduinoIoTCloudLPWAN::sendPropertiesToCloud()
   int bytes_encoded = 0;
   uint8_t data[CBOR_LORA_MSG_MAX_SIZE];
 
-  if (CBOREncoder::encode(_thing_property_container, data, sizeof(data), bytes_encoded, _last_checked_property_index, true) == CborNoError)
+  if (CBOREncoder::encode(_thing_property_container, data, sizeof(data), bytes_encoded, _last_checked_property_index, true, false, _shortestFloatEnable) == CborNoError)
     if (bytes_encoded > 0)
       writeProperties(data, bytes_encoded);
 }
@@ -44,10 +44,13 @@ class ArduinoIoTCloudLPWAN : public ArduinoIoTCloudClass
     inline bool isRetryEnabled  () const { return _retryEnable; }
     inline int  getMaxRetry     () const { return _maxNumRetry; }
     inline long getIntervalRetry() const { return _intervalRetry; }
+    inline bool isShortestFloatEnabled() const { return _shortestFloatEnable; }
 
     inline void enableRetry     (bool val) { _retryEnable = val; }
     inline void setMaxRetry     (int val)  { _maxNumRetry = val; }
     inline void setIntervalRetry(long val) { _intervalRetry = val; }
+    /* Encode float values as integers or half floats whenever that is lossless to fit more properties per uplink */
+    inline void enableShortestFloat(bool val) { _shortestFloatEnable = val; }
 
     inline PropertyContainer &getThingPropertyContainer() { return _thing_property_container; }
 
@@ -65,6 +68,7 @@ class ArduinoIoTCloudLPWAN : public ArduinoIoTCloudClass
     bool _retryEnable;
     int _maxNumRetry;
     long _intervalRetry;
+    bool _shortestFloatEnable;
 
     PropertyContainer _thing_property_container;
     unsigned int _last_checked_property_index;
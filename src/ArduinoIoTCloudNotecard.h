@@ -24,6 +24,7 @@
  ******************************************************************************/
 
 #define USE_LIGHT_PAYLOADS (false)
+#define USE_SHORTEST_FLOATS (false)
 
 /******************************************************************************
  * CONSTANTS
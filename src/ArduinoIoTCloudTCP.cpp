@@ -53,15 +53,27 @@ ArduinoIoTCloudTCP::ArduinoIoTCloudTCP()
 , _message_stream(std::bind(&ArduinoIoTCloudTCP::sendMessage, this, std::placeholders::_1))
 , _thing(&_message_stream)
 , _device(&_message_stream)
-, _mqtt_data_buf{0}
+, _mqtt_buf_size{AIOT_CONFIG_MQTT_TRANSMIT_BUFFER_SIZE}
+, _mqtt_tx_buf{nullptr}
 , _mqtt_data_len{0}
+, _mqtt_rx_buf_size{AIOT_CONFIG_MQTT_RECEIVE_BUFFER_SIZE}
+, _mqtt_rx_buf()
+, _mqtt_tx_queue_depth{0}
+, _mqtt_tx_queue()
+, _offline_store{nullptr}
 , _mqtt_data_request_retransmit{false}
+, _property_burst_enabled{false}
+, _property_burst_max_bytes{AIOT_CONFIG_PROPERTY_BURST_MAX_BYTES}
+, _property_burst_max_time_ms{AIOT_CONFIG_PROPERTY_BURST_MAX_TIME_ms}
+, _senml_base_fields_enabled{false}
+, _shortest_float_enabled{false}
 #ifdef BOARD_HAS_SECRET_KEY
 , _password("")
 #endif
 #if defined(BOARD_HAS_SECURE_ELEMENT)
 , _writeCertOnConnect(false)
 #endif
+, _mqttAckClient(_brokerClient, _mqtt_tx_queue)
 , _mqttClient{nullptr}
 , _messageTopicOut("")
 , _messageTopicIn("")
@@ -154,7 +166,20 @@ int ArduinoIoTCloudTCP::begin(bool const enable_watchdog, String brokerAddress,
   _brokerAddress = brokerAddress;
   _brokerPort = brokerPort;
 
-  _mqttClient.setClient(_brokerClient);
+  /* Allocate the outbound and inbound buffers once, with the sizes selected before begin() */
+  if (_mqtt_tx_buf == nullptr) {
+    _mqtt_tx_buf = new uint8_t[_mqtt_buf_size];
+  }
+  _mqtt_rx_buf.begin(_mqtt_rx_buf_size, AIOT_CONFIG_MQTT_RECEIVE_MAX_MESSAGE_SIZE);
+  if (_mqtt_tx_queue_depth > 0) {
+    _mqtt_tx_queue.begin(_mqtt_tx_queue_depth, _mqtt_buf_size);
+  }
+  if (_offline_store != nullptr && !_offline_store->begin()) {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not initialize the offline store", __FUNCTION__);
+    _offline_store = nullptr;
+  }
+
+  _mqttClient.setClient(_mqttAckClient);
 
 #ifdef BOARD_HAS_SECRET_KEY
   if(_password.length())
@@ -212,6 +237,16 @@ int ArduinoIoTCloudTCP::begin(bool const enable_watchdog, String brokerAddress,
   return 1;
 }
 
+bool ArduinoIoTCloudTCP::setMqttTransmitBufferSize(size_t const size)
+{
+  if (_mqtt_tx_buf != nullptr) {
+    DEBUG_WARNING("ArduinoIoTCloudTCP::%s must be called before begin(), keeping %d bytes", __FUNCTION__, static_cast<int>(_mqtt_buf_size));
+    return false;
+  }
+  _mqtt_buf_size = size;
+  return true;
+}
+
 void ArduinoIoTCloudTCP::update()
 {
   /* Feed the watchdog. If any of the functions called below
@@ -233,6 +268,13 @@ void ArduinoIoTCloudTCP::update()
   }
   _state = next_state;
 
+  /* While disconnected keep every timestamped update instead of the latest value only. The records
+   * belong to the attached thing, the device is attached once it has been connected.
+   */
+  if (_offline_store != nullptr && _state != State::Connected && _device.isAttached() && _thing.getPropertyContainer().hasPending()) {
+    storeOfflineProperties();
+  }
+
   /* This watchdog feed is actually needed only by the RP2040 Connect because its
    * maximum watchdog window is 8389 ms; despite this we feed it for all
    * supported ARCH to keep code aligned.
@@ -289,6 +331,13 @@ ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_ConnectPhy()
 
 ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_SyncTime()
 {
+  /* After a brief disconnection the RTC is still accurate, skip the network time sync which may block */
+  if (_time_service.isTimeTrusted())
+  {
+    DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s internal clock synced %d s ago, skipping time sync", __FUNCTION__, _time_service.getSyncAge() / 1000);
+    return State::ConnectMqttBroker;
+  }
+
   /* If available force network time sync when connecting or reconnecting */
   if (_time_service.sync())
   {
@@ -296,6 +345,12 @@ ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_SyncTime()
     return State::ConnectMqttBroker;
   }
 
+  /* The network time request does not block, its answer is collected by the next update() */
+  if (_time_service.isSyncPending())
+  {
+    return State::SyncTime;
+  }
+
   DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not get valid time. Retrying now.", __FUNCTION__);
   return State::ConnectPhy;
 }
@@ -349,10 +404,20 @@ ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_Connected()
    * to phy layer or MQTT connectivity loss.
    */
   if (_mqtt_data_request_retransmit && (_mqtt_data_len > 0)) {
-    write(_dataTopicOut, _mqtt_data_buf, _mqtt_data_len);
+    write(_dataTopicOut, _mqtt_tx_buf, _mqtt_data_len);
     _mqtt_data_request_retransmit = false;
   }
 
+  /* The PUBACKs read by poll() have released their queued messages, publish the ones waiting for a free slot */
+  if (!_mqtt_tx_queue.empty()) {
+    publishQueuedMessages();
+  }
+
+  /* Publish the updates recorded while disconnected, one batch per call */
+  if (_offline_store != nullptr && _device.isAttached() && !_offline_store->empty()) {
+    publishOfflineProperties();
+  }
+
   /* Call CloudDevice process to get configuration */
   _device.update();
 
@@ -374,6 +439,9 @@ ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_Disconnect()
     _mqttClient.stop();
   }
 
+  /* The queued messages in flight may have been lost, publish them again once reconnected */
+  _mqtt_tx_queue.requeueInFlight();
+
   Message message = { ResetCmdId };
   _thing.handleMessage(&message);
   _device.handleMessage(&message);
@@ -395,15 +463,17 @@ void ArduinoIoTCloudTCP::handleMessage(int length)
 {
   String topic = _mqttClient.messageTopic();
 
-  byte bytes[length];
-
-  for (int i = 0; i < length; i++) {
-    bytes[i] = _mqttClient.read();
+  if (!_mqtt_rx_buf.read(_mqttClient, length)) {
+    DEBUG_WARNING("ArduinoIoTCloudTCP::%s [%d] dropped message of %d bytes, receive buffer is %d bytes", __FUNCTION__, millis(), length, static_cast<int>(_mqtt_rx_buf.size()));
+    return;
   }
 
+  /* The decoders work on the message in place */
+  uint8_t const * bytes = _mqtt_rx_buf.data();
+
   /* Topic for user input data */
   if (_dataTopicIn == topic) {
-    CBORDecoder::decode(_thing.getPropertyContainer(), (uint8_t*)bytes, length);
+    CBORDecoder::decode(_thing.getPropertyContainer(), bytes, length);
   }
 
   /* Topic for device commands */
@@ -461,17 +531,10 @@ void ArduinoIoTCloudTCP::handleMessage(int length)
         {
           DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] last values received", __FUNCTION__, millis());
           CBORDecoder::decode(_thing.getPropertyContainer(),
-            (uint8_t*)command.lastValuesUpdateCmd.params.last_values,
+            command.lastValuesUpdateCmd.params.last_values,
             command.lastValuesUpdateCmd.params.length, true);
           _thing.handleMessage((Message*)&command);
           execCloudEventCallback(ArduinoIoTCloudEvent::SYNC);
-
-          /*
-           * NOTE: in this current version properties are not properly integrated with the new paradigm of
-           * modeling the messages with C structs. The current CBOR library allocates an array in the heap
-           * thus we need to delete it after decoding it with the old CBORDecoder
-           */
-          free(command.lastValuesUpdateCmd.params.last_values);
         }
         break;
 
@@ -488,12 +551,12 @@ void ArduinoIoTCloudTCP::handleMessage(int length)
       }
     }
   }
+
+  _mqtt_rx_buf.release();
 }
 
 void ArduinoIoTCloudTCP::sendMessage(Message * msg)
 {
-  uint8_t data[MQTT_TRANSMIT_BUFFER_SIZE];
-  size_t bytes_encoded = sizeof(data);
   CBORMessageEncoder encoder;
 
   switch (msg->id) {
@@ -507,9 +570,20 @@ void ArduinoIoTCloudTCP::sendMessage(Message * msg)
       break;
   }
 
-  if (encoder.encode(msg, data, bytes_encoded) == MessageEncoder::Status::Complete &&
+  /* Keep the property message waiting for retransmission, unless the message does not fit after it */
+  size_t offset = (_mqtt_data_len > 0) ? static_cast<size_t>(_mqtt_data_len) : 0;
+  size_t bytes_encoded = _mqtt_buf_size - offset;
+  MessageEncoder::Status status = encoder.encode(msg, _mqtt_tx_buf + offset, bytes_encoded);
+  if (status != MessageEncoder::Status::Complete && offset > 0) {
+    _mqtt_data_len = 0;
+    offset = 0;
+    bytes_encoded = _mqtt_buf_size;
+    status = encoder.encode(msg, _mqtt_tx_buf, bytes_encoded);
+  }
+
+  if (status == MessageEncoder::Status::Complete &&
       bytes_encoded > 0) {
-    write(_messageTopicOut, data, bytes_encoded);
+    write(_messageTopicOut, _mqtt_tx_buf + offset, bytes_encoded);
   } else {
     DEBUG_ERROR("error encoding %d", msg->id);
   }
@@ -517,22 +591,60 @@ void ArduinoIoTCloudTCP::sendMessage(Message * msg)
 
 void ArduinoIoTCloudTCP::sendPropertyContainerToCloud(String const topic, PropertyContainer & property_container, unsigned int & current_property_index)
 {
-  int bytes_encoded = 0;
-  uint8_t data[MQTT_TRANSMIT_BUFFER_SIZE];
+  unsigned long const start_ms = millis();
+  size_t bytes_sent = 0;
 
-  if (CBOREncoder::encode(property_container, data, sizeof(data), bytes_encoded, current_property_index, false) == CborNoError)
-  {
-    if (bytes_encoded > 0)
+  if (_mqtt_tx_queue.depth() > 0) {
+    /* Encode straight into the free slots of the queue, while it is full the properties stay pending */
+    do
     {
-      /* If properties have been encoded store them in the back-up buffer
-       * in order to allow retransmission in case of failure.
-       */
-      _mqtt_data_len = bytes_encoded;
-      memcpy(_mqtt_data_buf, data, _mqtt_data_len);
-      /* Transmit the properties to the MQTT broker */
-      write(topic, _mqtt_data_buf, _mqtt_data_len);
-    }
+      uint8_t * slot = _mqtt_tx_queue.reserve();
+      if (slot == nullptr)
+        break;
+
+      int bytes_encoded = 0;
+      if (CBOREncoder::encode(property_container, slot, _mqtt_tx_queue.slotSize(), bytes_encoded, current_property_index, false, _senml_base_fields_enabled, _shortest_float_enabled) != CborNoError)
+        break;
+
+      if (bytes_encoded <= 0)
+        break;
+
+      _mqtt_tx_queue.commit(bytes_encoded);
+      bytes_sent += bytes_encoded;
+    } while (_property_burst_enabled &&
+             property_container.hasPending() &&
+             (bytes_sent < _property_burst_max_bytes) &&
+             ((millis() - start_ms) < _property_burst_max_time_ms));
+
+    publishQueuedMessages();
+    return;
   }
+
+  do
+  {
+    int bytes_encoded = 0;
+
+    /* Encode straight into the outbound buffer, the message stays there in order to allow
+     * retransmission in case of failure. In burst mode only the last message of the burst
+     * can be retransmitted.
+     */
+    _mqtt_data_len = 0;
+    if (CBOREncoder::encode(property_container, _mqtt_tx_buf, _mqtt_buf_size, bytes_encoded, current_property_index, false, _senml_base_fields_enabled, _shortest_float_enabled) != CborNoError)
+      return;
+
+    if (bytes_encoded <= 0)
+      return;
+
+    _mqtt_data_len = bytes_encoded;
+    /* Transmit the properties to the MQTT broker, stop the burst if the client does not accept more data */
+    if (!write(topic, _mqtt_tx_buf, _mqtt_data_len))
+      return;
+
+    bytes_sent += bytes_encoded;
+  } while (_property_burst_enabled &&
+           property_container.hasPending() &&
+           (bytes_sent < _property_burst_max_bytes) &&
+           ((millis() - start_ms) < _property_burst_max_time_ms));
 }
 
 void ArduinoIoTCloudTCP::attachThing(String thingId)
@@ -564,6 +676,9 @@ void ArduinoIoTCloudTCP::detachThing()
     return;
   }
 
+  /* The queued property messages belong to the detached thing */
+  _mqtt_tx_queue.clear();
+
   Message message;
   message = { DeviceDetachedCmdId };
   _device.handleMessage(&message);
@@ -573,9 +688,103 @@ void ArduinoIoTCloudTCP::detachThing()
   execCloudEventCallback(ArduinoIoTCloudEvent::DISCONNECT);
 }
 
-int ArduinoIoTCloudTCP::write(String const topic, byte const data[], int const length)
+void ArduinoIoTCloudTCP::publishQueuedMessages()
+{
+  uint8_t const * data = nullptr;
+  size_t length = 0;
+  bool dup = false;
+
+  /* Pipeline the messages, stop at the first one the client does not accept and retry later */
+  while (_mqtt_tx_queue.nextUnsent(data, length, dup)) {
+    if (!write(_dataTopicOut, data, length, 1, dup))
+      return;
+    _mqtt_tx_queue.markSent(_mqttAckClient.publishedPacketId());
+  }
+}
+
+void ArduinoIoTCloudTCP::storeOfflineProperties()
+{
+  PropertyContainer & property_container = _thing.getPropertyContainer();
+
+  /* Only the changes marked pending are visited: the polled properties change without notice
+   * and get their timestamp updated while connected, they are published with their latest value.
+   */
+  for (size_t idx = property_container.nextMarked(0); idx < property_container.size(); idx = property_container.nextMarked(idx + 1))
+  {
+    Property * p = property_container[idx];
+
+    /* Nothing to store right now, wait for the next change or deadline as the encoder does */
+    if (!p->shouldBeUpdated()) {
+      property_container.clearPending(idx);
+      p->updateDeadline();
+      continue;
+    }
+
+    /* Only the records carrying their own timestamp keep their meaning when published later,
+     * the others stay pending and are published with their latest value once reconnected.
+     */
+    if (!p->isTimestampEncoded() || (p->timestamp() == 0) || !p->isReadableByCloud())
+      continue;
+
+    /* The outbound buffer is not in use while disconnected. Encoding fails before the property
+     * is marked as sent if the record does not fit into the store, it stays pending then.
+     */
+    size_t const free_space = _offline_store->freeSpace() + 1;
+    size_t bytes_encoded = 0;
+    _mqtt_data_len = 0;
+    if (CBOREncoder::encodeRecords(*p, _mqtt_tx_buf, (free_space < _mqtt_buf_size) ? free_space : _mqtt_buf_size, bytes_encoded, _shortest_float_enabled) != CborNoError)
+      continue;
+
+    if (!_offline_store->push(_mqtt_tx_buf, bytes_encoded)) {
+      DEBUG_WARNING("ArduinoIoTCloudTCP::%s could not store %s update", __FUNCTION__, p->nameCStr());
+      continue;
+    }
+    p->appendCompleted();
+    property_container.clearPending(idx);
+  }
+}
+
+void ArduinoIoTCloudTCP::publishOfflineProperties()
+{
+  /* Encode the batch into a free slot of the queue if enabled, into the outbound buffer otherwise */
+  uint8_t * buf = nullptr;
+  size_t size = 0;
+  if (_mqtt_tx_queue.depth() > 0) {
+    buf = _mqtt_tx_queue.reserve();
+    size = _mqtt_tx_queue.slotSize();
+    if (buf == nullptr)
+      return;
+  } else {
+    _mqtt_data_len = 0;
+    buf = _mqtt_tx_buf;
+    size = _mqtt_buf_size;
+  }
+
+  /* The stored records are put back to back into an array of indefinite length,
+   * opened by 0x9F and closed by the 0xFF break byte.
+   */
+  size_t count = 0;
+  size_t const length = _offline_store->peek(buf + 1, size - 2, count);
+  if (count == 0) {
+    DEBUG_WARNING("ArduinoIoTCloudTCP::%s offline record larger than %d bytes dropped", __FUNCTION__, static_cast<int>(size));
+    _offline_store->pop(1);
+    return;
+  }
+  buf[0] = 0x9F;
+  buf[length + 1] = 0xFF;
+
+  if (_mqtt_tx_queue.depth() > 0) {
+    _mqtt_tx_queue.commit(length + 2);
+    _offline_store->pop(count);
+    publishQueuedMessages();
+  } else if (write(_dataTopicOut, buf, length + 2)) {
+    _offline_store->pop(count);
+  }
+}
+
+int ArduinoIoTCloudTCP::write(String const topic, byte const data[], int const length, uint8_t const qos, bool const dup)
 {
-  if (_mqttClient.beginMessage(topic, length, false, 0)) {
+  if (_mqttClient.beginMessage(topic, length, false, qos, dup)) {
     if (_mqttClient.write(data, length)) {
       if (_mqttClient.endMessage()) {
         return 1;
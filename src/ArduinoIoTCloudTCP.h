@@ -43,6 +43,11 @@
 
 #include "cbor/IoTCloudMessageDecoder.h"
 #include "cbor/IoTCloudMessageEncoder.h"
+#include "utility/mqtt/MqttReceiveBuffer.h"
+#include "utility/mqtt/MqttOutboundQueue.h"
+#include "utility/mqtt/MqttAckClient.h"
+#include "utility/store/OfflineRamStore.h"
+#include "utility/store/OfflineFileStore.h"
 
 /******************************************************************************
    CONSTANTS
@@ -90,6 +95,70 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
 
     inline PropertyContainer &getThingPropertyContainer() { return _thing.getPropertyContainer(); }
 
+    /* By default at most one message of changed properties is published per update().
+     * In burst mode successive messages are published within the same update() until
+     * no property is left to send, max_bytes have been published or max_time_ms elapsed.
+     */
+    inline void enablePropertyBurst(size_t const max_bytes = AIOT_CONFIG_PROPERTY_BURST_MAX_BYTES, unsigned long const max_time_ms = AIOT_CONFIG_PROPERTY_BURST_MAX_TIME_ms) {
+      _property_burst_enabled = true;
+      _property_burst_max_bytes = max_bytes;
+      _property_burst_max_time_ms = max_time_ms;
+    }
+    inline void disablePropertyBurst() { _property_burst_enabled = false; }
+
+    /* Larger messages reduce the MQTT and TLS overhead per property on boards with enough RAM.
+     * Must be called before begin(), which allocates the buffer once: later calls are rejected
+     * with a warning and return false.
+     */
+    bool setMqttTransmitBufferSize(size_t const size);
+    inline size_t getMqttTransmitBufferSize() const { return _mqtt_buf_size; }
+
+    /* Inbound messages larger than the receive buffer, e.g. the last values of a big Thing, are
+     * read into a one-off allocation up to AIOT_CONFIG_MQTT_RECEIVE_MAX_MESSAGE_SIZE bytes and
+     * dropped if it fails. The buffer is allocated once by begin(), the size can not be changed afterwards.
+     */
+    inline void setMqttReceiveBufferSize(size_t const size) {
+      if (_mqtt_rx_buf.size() == 0) {
+        _mqtt_rx_buf_size = size;
+      }
+    }
+    inline size_t getMqttReceiveBufferSize() const { return _mqtt_rx_buf_size; }
+    /* Number of inbound messages dropped because they could not be read */
+    inline unsigned long getMqttDroppedMessages() const { return _mqtt_rx_buf.droppedMessages(); }
+
+    /* Publish the property messages with QoS 1 through a queue of depth messages, each one of
+     * the transmit buffer size. Up to depth messages are in flight at the same time and the ones
+     * not acknowledged are published again after a reconnection. While the queue is full the
+     * properties stay pending. The queue is allocated once by begin(), enable it before.
+     */
+    inline void enableOutboundQueue(size_t const depth = AIOT_CONFIG_MQTT_OUTBOUND_QUEUE_DEPTH) {
+      if (_mqtt_tx_queue.depth() == 0) {
+        _mqtt_tx_queue_depth = depth;
+      }
+    }
+    inline void disableOutboundQueue() { enableOutboundQueue(0); }
+    /* Number of property messages waiting to be published or acknowledged */
+    inline size_t getOutboundQueueSize() const { return _mqtt_tx_queue.size(); }
+
+    /* Record the updates of the properties with a timestamp, see Property::encodeTimestamp(),
+     * into store while disconnected instead of keeping only their latest value. Once reconnected
+     * the records are published oldest first, batched into messages of the transmit buffer size.
+     * The store, e.g. an OfflineRamStore or an OfflineFileStore on host builds, is not owned and
+     * begin() is called on it by begin().
+     */
+    inline void enableOfflineStore(OfflineStore & store) { _offline_store = &store; }
+    inline void disableOfflineStore() { _offline_store = nullptr; }
+
+    /* Publish the property messages using the SenML base name and base time fields, which
+     * shortens the messages of multi-value and timestamped properties.
+     */
+    inline void enableSenMLBaseFields() { _senml_base_fields_enabled = true; }
+    inline void disableSenMLBaseFields() { _senml_base_fields_enabled = false; }
+
+    /* Publish float values as integers or half floats whenever that is lossless, e.g. 21.5 or 0.0 */
+    inline void enableShortestFloatEncoding() { _shortest_float_enabled = true; }
+    inline void disableShortestFloatEncoding() { _shortest_float_enabled = false; }
+
 #if OTA_ENABLED
     /* The callback is triggered when the OTA is initiated and it gets executed until _ota_req flag is cleared.
      * It should return true when the OTA can be applied or false otherwise.
@@ -116,8 +185,6 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
 #endif
 
   private:
-    static const int MQTT_TRANSMIT_BUFFER_SIZE = 256;
-
     enum class State
     {
       ConnectPhy,
@@ -135,9 +202,23 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
 
     String _brokerAddress;
     uint16_t _brokerPort;
-    uint8_t _mqtt_data_buf[MQTT_TRANSMIT_BUFFER_SIZE];
+    size_t _mqtt_buf_size;
+    /* Outbound buffer messages are encoded into. The last property message is kept at its
+     * start for retransmission, the other messages are encoded in the space left after it.
+     */
+    uint8_t * _mqtt_tx_buf;
     int _mqtt_data_len;
+    size_t _mqtt_rx_buf_size;
+    MqttReceiveBuffer _mqtt_rx_buf;
+    size_t _mqtt_tx_queue_depth;
+    MqttOutboundQueue _mqtt_tx_queue;
+    OfflineStore * _offline_store;
     bool _mqtt_data_request_retransmit;
+    bool _property_burst_enabled;
+    size_t _property_burst_max_bytes;
+    unsigned long _property_burst_max_time_ms;
+    bool _senml_base_fields_enabled;
+    bool _shortest_float_enabled;
 
 #if defined(BOARD_HAS_SECRET_KEY)
     String _password;
@@ -151,6 +232,7 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
 #endif
 
     TLSClientMqtt _brokerClient;
+    MqttAckClient _mqttAckClient;
     MqttClient _mqttClient;
 
     String _messageTopicOut;
@@ -183,7 +265,10 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
 
     void attachThing(String thingId);
     void detachThing();
-    int write(String const topic, byte const data[], int const length);
+    void publishQueuedMessages();
+    void storeOfflineProperties();
+    void publishOfflineProperties();
+    int write(String const topic, byte const data[], int const length, uint8_t const qos = 0, bool const dup = false);
 
 };
 
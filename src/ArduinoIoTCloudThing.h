@@ -40,6 +40,10 @@ public:
   inline unsigned int &getPropertyContainerIndex() {
     return _propertyContainerIndex;
   }
+  /* millis() timestamp of the next property due to be published */
+  inline unsigned long nextDeadlineMillis() {
+    return ::nextDeadlineMillis(_propertyContainer, millis());
+  }
 
 private:
 
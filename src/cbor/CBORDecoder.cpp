@@ -27,6 +27,12 @@
 
 #include "CBORDecoder.h"
 
+/******************************************************************************
+   STATIC MEMBER DEFINITION
+ ******************************************************************************/
+
+CborMapDataArena CBORDecoder::_map_data_arena;
+
 /******************************************************************************
    PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
@@ -36,10 +42,12 @@ void CBORDecoder::decode(PropertyContainer & property_container, uint8_t const *
   CborValue array_iter, map_iter,value_iter;
   CborParser parser;
   CborMapData map_data;
-  std::list<CborMapData> map_data_list; /* List of map data that will hold all the attributes of a property */
-  String current_property_name; /* Current property name during decoding: use to look for a new property in the senml value array */
+  Property * current_property = nullptr; /* Current property during decoding: use to look for a new property in the senml value array */
   unsigned long current_property_base_time{0}, current_property_time{0};
 
+  /* Holds all the attributes of a property */
+  _map_data_arena.clear();
+
   if (cbor_parser_init(payload, length, 0, &parser, &array_iter) != CborNoError)
     return;
 
@@ -66,7 +74,7 @@ void CBORDecoder::decode(PropertyContainer & property_container, uint8_t const *
       case MapParserState::Value        : next_state = handle_Value(&value_iter, map_data); break;
       case MapParserState::StringValue  : next_state = handle_StringValue(&value_iter, map_data); break;
       case MapParserState::BooleanValue : next_state = handle_BooleanValue(&value_iter, map_data); break;
-      case MapParserState::LeaveMap     : next_state = handle_LeaveMap(&map_iter, &value_iter, map_data, property_container, current_property_name, current_property_base_time, current_property_time, isSyncMessage, map_data_list); break;
+      case MapParserState::LeaveMap     : next_state = handle_LeaveMap(&map_iter, &value_iter, map_data, property_container, current_property, current_property_base_time, current_property_time, isSyncMessage); break;
       case MapParserState::Complete     : /* Nothing to do */ break;
       case MapParserState::Error        : return; break;
     }
@@ -160,14 +168,10 @@ CBORDecoder::MapParserState CBORDecoder::handle_BaseVersion(CborValue * value_it
 CBORDecoder::MapParserState CBORDecoder::handle_BaseName(CborValue * value_iter, CborMapData & map_data) {
   MapParserState next_state = MapParserState::Error;
 
-  if (cbor_value_is_text_string(value_iter)) {
-    char * val      = 0;
-    size_t val_size = 0;
-    if (cbor_value_dup_text_string(value_iter, &val, &val_size, value_iter) == CborNoError) {
-      map_data.base_name.set(String(val));
-      free(val);
-      next_state = MapParserState::MapKey;
-    }
+  StringView val;
+  if (getTextString(value_iter, val)) {
+    map_data.base_name.set(val);
+    next_state = MapParserState::MapKey;
   }
 
   return next_state;
@@ -193,18 +197,10 @@ CBORDecoder::MapParserState CBORDecoder::handle_Name(CborValue * value_iter, Cbo
 
   if (cbor_value_is_text_string(value_iter)) {
     // if the value in the cbor message is a string, it corresponds to the name of the property to be updated (int the form [property_name]:[attribute_name])
-    char * val      = nullptr;
-    size_t val_size = 0;
-    if (cbor_value_dup_text_string(value_iter, &val, &val_size, value_iter) == CborNoError) {
-      String name = val;
-      free(val);
-      map_data.name.set(name);
-      int colonPos = name.indexOf(":");
-      String attribute_name = "";
-      if (colonPos != -1) {
-        attribute_name = name.substring(colonPos + 1);
-      }
-      map_data.attribute_name.set(attribute_name);
+    StringView val;
+    if (getTextString(value_iter, val)) {
+      map_data.name.set(val);
+      map_data.property.reset();
       next_state = MapParserState::MapKey;
     }
   } else if (cbor_value_is_integer(value_iter)) {
@@ -212,12 +208,9 @@ CBORDecoder::MapParserState CBORDecoder::handle_Name(CborValue * value_iter, Cbo
     int val = 0;
     if (cbor_value_get_int(value_iter, &val) == CborNoError) {
       map_data.light_payload.set(true);
-      map_data.name_identifier.set(val & 255);
       map_data.attribute_identifier.set(val >> 8);
-      map_data.light_payload.set(true);
-      String name = getPropertyNameByIdentifier(property_container, val);
-      map_data.name.set(name);
-
+      /* Resolve the property straight from the identifier table, no name lookup needed */
+      map_data.property.set(getProperty(property_container, val & 255));
 
       if (cbor_value_advance(value_iter) == CborNoError) {
         next_state = MapParserState::MapKey;
@@ -248,14 +241,10 @@ CBORDecoder::MapParserState CBORDecoder::handle_Value(CborValue * value_iter, Cb
 CBORDecoder::MapParserState CBORDecoder::handle_StringValue(CborValue * value_iter, CborMapData & map_data) {
   MapParserState next_state = MapParserState::Error;
 
-  if (cbor_value_is_text_string(value_iter)) {
-    char * val      = 0;
-    size_t val_size = 0;
-    if (cbor_value_dup_text_string(value_iter, &val, &val_size, value_iter) == CborNoError) {
-      map_data.str_val.set(String(val));
-      free(val);
-      next_state = MapParserState::MapKey;
-    }
+  StringView val;
+  if (getTextString(value_iter, val)) {
+    map_data.str_val.set(val);
+    next_state = MapParserState::MapKey;
   }
 
   return next_state;
@@ -291,22 +280,21 @@ CBORDecoder::MapParserState CBORDecoder::handle_Time(CborValue * value_iter, Cbo
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container, String & current_property_name, unsigned long & current_property_base_time, unsigned long & current_property_time, bool const is_sync_message, std::list<CborMapData> & map_data_list) {
+CBORDecoder::MapParserState CBORDecoder::handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container, Property * & current_property, unsigned long & current_property_base_time, unsigned long & current_property_time, bool const is_sync_message) {
   MapParserState next_state = MapParserState::Error;
-  if (map_data.name.isSet()) {
-    String propertyName;
-    int colonPos = map_data.name.get().indexOf(":");
-    if (colonPos != -1) {
-      propertyName = map_data.name.get().substring(0, colonPos);
+  if (map_data.property.isSet() || map_data.name.isSet()) {
+    Property * property = nullptr;
+    if (map_data.property.isSet()) {
+      property = map_data.property.get();
     } else {
-      propertyName = map_data.name.get();
+      property = getPropertyByName(property_container, map_data);
     }
 
-    if (current_property_name != "" && propertyName != current_property_name) {
+    if (property != current_property) {
       /* Update the property containers depending on the parsed data */
-      updateProperty(property_container, current_property_name, current_property_base_time + current_property_time, is_sync_message, &map_data_list);
+      updateProperty(property_container, current_property, current_property_base_time + current_property_time, is_sync_message, &_map_data_arena);
       /* Reset current property data */
-      map_data_list.clear();
+      _map_data_arena.clear();
       current_property_base_time = 0;
       current_property_time = 0;
     }
@@ -317,8 +305,8 @@ CBORDecoder::MapParserState CBORDecoder::handle_LeaveMap(CborValue * map_iter, C
     if (map_data.time.isSet() && (map_data.time.get() > current_property_time)) {
       current_property_time = (unsigned long)map_data.time.get();
     }
-    map_data_list.push_back(map_data);
-    current_property_name = propertyName;
+    _map_data_arena.add(map_data);
+    current_property = property;
   }
 
   /* Transition into the next map if available, otherwise finish */
@@ -327,9 +315,9 @@ CBORDecoder::MapParserState CBORDecoder::handle_LeaveMap(CborValue * map_iter, C
       next_state = MapParserState::EnterMap;
     } else {
       /* Update the property containers depending on the parsed data */
-      updateProperty(property_container, current_property_name, current_property_base_time + current_property_time, is_sync_message, &map_data_list);
+      updateProperty(property_container, current_property, current_property_base_time + current_property_time, is_sync_message, &_map_data_arena);
       /* Reset last property data */
-      map_data_list.clear();
+      _map_data_arena.clear();
       next_state = MapParserState::Complete;
     }
   }
@@ -337,6 +325,57 @@ CBORDecoder::MapParserState CBORDecoder::handle_LeaveMap(CborValue * map_iter, C
   return next_state;
 }
 
+Property * CBORDecoder::getPropertyByName(PropertyContainer & property_container, CborMapData & map_data) {
+  /* Names are in the form [property_name]:[attribute_name] for multi-value properties */
+  StringView property_name = map_data.name.get(), attribute_name;
+  map_data.name.get().split(':', property_name, attribute_name);
+
+  /* The base name applies to all the following records of the message, either as the
+   * [property_name]: part of the names or as a prefix of the property names. Base names
+   * that do not resolve to a property of the container, e.g. the ones of the cloud, are ignored.
+   */
+  if (map_data.base_name.isSet() && !map_data.base_name.get().empty()) {
+    StringView const & base_name = map_data.base_name.get();
+    StringView base_property_name, base_attribute_name;
+    Property * property = nullptr;
+
+    if (!base_name.split(':', base_property_name, base_attribute_name)) {
+      property = getProperty(property_container, base_name, property_name);
+    } else if (base_attribute_name.empty()) {
+      property = getProperty(property_container, StringView(), base_property_name);
+      attribute_name = map_data.name.get();
+    }
+
+    if (property != nullptr) {
+      map_data.attribute_name.set(attribute_name);
+      return property;
+    }
+  }
+
+  map_data.attribute_name.set(attribute_name);
+  return getProperty(property_container, StringView(), property_name);
+}
+
+bool CBORDecoder::getTextString(CborValue * value_iter, StringView & str) {
+  /* Chunked strings are not contiguous in the payload and are never sent by the cloud */
+  if (!cbor_value_is_text_string(value_iter) || !cbor_value_is_length_known(value_iter)) {
+    return false;
+  }
+
+  size_t length = 0;
+  if (cbor_value_get_string_length(value_iter, &length) != CborNoError) {
+    return false;
+  }
+  if (cbor_value_advance(value_iter) != CborNoError) {
+    return false;
+  }
+
+  /* After advancing the iterator points right past the characters of the string */
+  char const * end = reinterpret_cast<char const *>(cbor_value_get_next_byte(value_iter));
+  str = StringView(end - length, length);
+  return true;
+}
+
 bool CBORDecoder::ifNumericConvertToDouble(CborValue * value_iter, double * numeric_val) {
 
   if (cbor_value_is_integer(value_iter)) {
@@ -24,10 +24,6 @@
 
 #include <Arduino.h>
 
-#undef max
-#undef min
-#include <list>
-
 #include "../property/PropertyContainer.h"
 
 /******************************************************************************
@@ -48,6 +44,9 @@ private:
   CBORDecoder() { }
   CBORDecoder(CBORDecoder const &) { }
 
+  /* Records of the property being decoded, reused across decode calls */
+  static CborMapDataArena _map_data_arena;
+
   enum class MapParserState {
     EnterMap,
     MapKey,
@@ -76,8 +75,10 @@ private:
   static MapParserState handle_StringValue(CborValue * value_iter, CborMapData & map_data);
   static MapParserState handle_BooleanValue(CborValue * value_iter, CborMapData & map_data);
   static MapParserState handle_Time(CborValue * value_iter, CborMapData & map_data);
-  static MapParserState handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container, String & current_property_name, unsigned long & current_property_base_time, unsigned long & current_property_time, bool const is_sync_message, std::list<CborMapData> & map_data_list);
+  static MapParserState handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container, Property * & current_property, unsigned long & current_property_base_time, unsigned long & current_property_time, bool const is_sync_message);
 
+  static Property * getPropertyByName(PropertyContainer & property_container, CborMapData & map_data);
+  static bool   getTextString(CborValue * value_iter, StringView & str);
   static bool   ifNumericConvertToDouble(CborValue * value_iter, double * numeric_val);
   static double convertCborHalfFloatToDouble(uint16_t const half_val);
 
@@ -26,18 +26,35 @@
 #include <algorithm>
 #include <iterator>
 
+#include <string.h>
+
 #include <Arduino_TinyCBOR.h>
 
+/******************************************************************************
+ * INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Upper bound of the bytes the base fields can add to a property on top of its size hint.
+ * The first record of a property may carry "bn" (key + text string holding the "name:"
+ * prefix) and the first record of the message "bt" (key + time, at most a 64 bit integer).
+ */
+static size_t baseFieldsSizeSlack(Property const & property)
+{
+  size_t const prefix_len = strlen(property.nameCStr()) + 1;
+  size_t const prefix_header_size = (prefix_len < 24) ? 1 : (prefix_len <= UINT8_MAX) ? 2 : 3;
+  return (1 + prefix_header_size + prefix_len) + (1 + 9);
+}
+
 /******************************************************************************
  * PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
 
-CborError CBOREncoder::encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload)
+CborError CBOREncoder::encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload, bool baseFields, bool shortestFloat)
 {
   EncoderState current_state = EncoderState::InitPropertyEncoder,
                next_state = EncoderState::InitPropertyEncoder;
 
-  PropertyContainerEncoder propertyEncoder(property_container, current_property_index);
+  PropertyContainerEncoder propertyEncoder(property_container, current_property_index, baseFields, shortestFloat);
 
   while (current_state != EncoderState::SendMessage) {
 
@@ -47,9 +64,7 @@ CborError CBOREncoder::encode(PropertyContainer & property_container, uint8_t *
       case EncoderState::TryAppend                : next_state = handle_TryAppend(propertyEncoder, lightPayload); break;
       case EncoderState::OutOfMemory              : next_state = handle_OutOfMemory(propertyEncoder); break;
       case EncoderState::SkipProperty             : next_state = handle_SkipProperty(propertyEncoder); break;
-      case EncoderState::TrimAppend               : next_state = handle_TrimAppend(propertyEncoder); break;
       case EncoderState::CloseCBORContainer       : next_state = handle_CloseCBORContainer(propertyEncoder); break;
-      case EncoderState::TrimClose                : next_state = handle_TrimClose(propertyEncoder); break;
       case EncoderState::FinishAppend             : next_state = handle_FinishAppend(propertyEncoder); break;
       case EncoderState::SendMessage              : /* Nothing to do */ break;
       case EncoderState::Error                    : return CborErrorInternalError; break;
@@ -66,6 +81,27 @@ CborError CBOREncoder::encode(PropertyContainer & property_container, uint8_t *
   return CborNoError;
 }
 
+CborError CBOREncoder::encodeRecords(Property & property, uint8_t * data, size_t const size, size_t & bytes_encoded, bool shortestFloat)
+{
+  CborEncoder encoder, arrayEncoder;
+  bytes_encoded = 0;
+
+  cbor_encoder_init(&encoder, data, size, 0);
+  CborError error = cbor_encoder_create_array(&encoder, &arrayEncoder, CborIndefiniteLength);
+  if (error != CborNoError)
+    return error;
+
+  /* No base fields, a record must not depend on the records encoded before it */
+  error = property.append(&arrayEncoder, false, shortestFloat);
+  if (error != CborNoError)
+    return error;
+
+  /* Drop the leading byte opening the array */
+  bytes_encoded = cbor_encoder_get_buffer_size(&arrayEncoder, data) - 1;
+  memmove(data, data + 1, bytes_encoded);
+  return CborNoError;
+}
+
 /******************************************************************************
    PRIVATE MEMBER FUNCTIONS
  ******************************************************************************/
@@ -74,8 +110,8 @@ CBOREncoder::EncoderState CBOREncoder::handle_InitPropertyEncoder(PropertyContai
 {
   propertyEncoder.encoded_property_count = 0;
   propertyEncoder.checked_property_count = 0;
-  propertyEncoder.encoded_property_limit = 0;
-  propertyEncoder.property_limit_active  = false;
+  /* Flag the properties whose publishing deadline has expired */
+  propertyEncoder.property_container.releaseDeadlines(millis());
   return EncoderState::OpenCBORContainer;
 }
 
@@ -83,6 +119,9 @@ CBOREncoder::EncoderState CBOREncoder::handle_OpenCBORContainer(PropertyContaine
 {
   propertyEncoder.encoded_property_count = 0;
   propertyEncoder.checked_property_count = 0;
+  propertyEncoder.buffer = data;
+  propertyEncoder.buffer_size = size;
+  propertyEncoder.base_fields = SenMLBaseFields();
   cbor_encoder_init(&propertyEncoder.encoder, data, size, 0);
   cbor_encoder_create_array(&propertyEncoder.encoder, &propertyEncoder.arrayEncoder, CborIndefiniteLength);
   return EncoderState::TryAppend;
@@ -94,35 +133,73 @@ CBOREncoder::EncoderState CBOREncoder::handle_TryAppend(PropertyContainerEncoder
    * and if that's the case encode the property into the CBOR.
    */
   CborError error = CborNoError;
-  PropertyContainer::iterator iter = propertyEncoder.property_container.begin();
-  std::advance(iter, propertyEncoder.current_property_index);
+  PropertyContainer & property_container = propertyEncoder.property_container;
+  size_t const first_property_index = propertyEncoder.current_property_index;
+  size_t idx = property_container.nextPending(first_property_index);
 
-  for(; iter != propertyEncoder.property_container.end(); iter++)
+  /* Only properties flagged as pending or polled can require an update, skip all the others */
+  for(; idx < property_container.size(); idx = property_container.nextPending(idx + 1))
   {
-    Property * p = * iter;
+    Property * p = property_container[idx];
 
     if (p->shouldBeUpdated() && p->isReadableByCloud())
     {
-      error = p->append(&propertyEncoder.arrayEncoder, lightPayload);
-      if(error == CborNoError)
-        propertyEncoder.encoded_property_count++;
+      /* Leave the property for the next message if its size hint does not fit in the space left,
+       * keeping one byte to close the array. The very first property is always tried so that
+       * oversized properties are skipped.
+       */
+      size_t const size_hint = p->appendSizeHint(lightPayload);
+      size_t const bytes_used = cbor_encoder_get_buffer_size(&propertyEncoder.arrayEncoder, propertyEncoder.buffer);
+      /* The hint does not account for the base fields, which may add a few bytes to the first records */
+      size_t const base_fields_slack = propertyEncoder.base_fields_enabled ? baseFieldsSizeSlack(*p) : 0;
+      if ((size_hint > 0) && (propertyEncoder.encoded_property_count > 0) && ((bytes_used + size_hint + base_fields_slack + 1) > propertyEncoder.buffer_size))
+      {
+        error = CborErrorOutOfMemory;
+        break;
+      }
+
+      /* Properties without a hint, or whose slack was not needed, are appended on trial: a property
+       * that does not fit with the closing byte is rolled back, leaving the message as it was.
+       */
+      CborEncoder const array_encoder = propertyEncoder.arrayEncoder;
+      SenMLBaseFields const base_fields = propertyEncoder.base_fields;
+      if (propertyEncoder.base_fields_enabled) {
+        error = p->append(&propertyEncoder.arrayEncoder, lightPayload, propertyEncoder.shortest_float_enabled, &propertyEncoder.base_fields);
+      } else {
+        error = p->append(&propertyEncoder.arrayEncoder, lightPayload, propertyEncoder.shortest_float_enabled);
+      }
+      if ((error == CborNoError) && (cbor_encoder_get_buffer_size(&propertyEncoder.arrayEncoder, propertyEncoder.buffer) >= propertyEncoder.buffer_size)) {
+        /* The property has been appended but the array can not be closed anymore, keep it pending */
+        error = CborErrorOutOfMemory;
+      }
+      if ((error == CborErrorOutOfMemory) || (error == CborErrorSplitItems)) {
+        propertyEncoder.arrayEncoder = array_encoder;
+        propertyEncoder.base_fields = base_fields;
+        error = CborErrorOutOfMemory;
+        break;
+      }
+      if (error != CborNoError)
+        break;
+      propertyEncoder.encoded_property_count++;
+    }
+    else
+    {
+      /* Nothing to send right now, wait for the next change or deadline */
+      property_container.clearPending(idx);
+      p->updateDeadline();
     }
-    if(error == CborNoError)
-      propertyEncoder.checked_property_count++;
-
-    bool const maximum_number_of_properties_reached = (propertyEncoder.encoded_property_count >= propertyEncoder.encoded_property_limit) && (propertyEncoder.property_limit_active == true);
-    bool const cbor_encoder_error = (error != CborNoError);
-
-    if (maximum_number_of_properties_reached || cbor_encoder_error)
-      break;
   }
 
+  /* Number of consecutive properties, starting from current_property_index, checked without errors */
+  if (error != CborNoError)
+    propertyEncoder.checked_property_count = idx - first_property_index;
+  else
+    propertyEncoder.checked_property_count = property_container.size() - first_property_index;
+
   if (CborErrorOutOfMemory == error)
     return EncoderState::OutOfMemory;
   else if (CborNoError == error)
     return EncoderState::CloseCBORContainer;
-  else if (CborErrorSplitItems == error)
-    return EncoderState::TrimAppend;
   else
     return EncoderState::Error;
 }
@@ -146,55 +223,29 @@ CBOREncoder::EncoderState CBOREncoder::handle_SkipProperty(PropertyContainerEnco
   return EncoderState::Error;
 }
 
-CBOREncoder::EncoderState CBOREncoder::handle_TrimAppend(PropertyContainerEncoder & propertyEncoder)
-{
-  /* Trim the number of properties to be included in the next message to avoid multivalue property split */
-  propertyEncoder.encoded_property_limit = propertyEncoder.encoded_property_count;
-  propertyEncoder.property_limit_active = true;
-  if(propertyEncoder.encoded_property_limit > 0)
-    return EncoderState::OpenCBORContainer;
-  else
-    return EncoderState::Error;
-}
-
 CBOREncoder::EncoderState CBOREncoder::handle_CloseCBORContainer(PropertyContainerEncoder & propertyEncoder)
 {
+  /* A byte is always left to close the array, see handle_TryAppend */
   CborError error = cbor_encoder_close_container(&propertyEncoder.encoder, &propertyEncoder.arrayEncoder);
   if (CborNoError != error)
-    return EncoderState::TrimClose;
+    return EncoderState::Error;
   else
     return EncoderState::FinishAppend;
 }
 
-CBOREncoder::EncoderState CBOREncoder::handle_TrimClose(PropertyContainerEncoder & propertyEncoder)
-{
-  /* Trim the number of properties to be included in the next message to avoid error closing container */
-  propertyEncoder.encoded_property_limit = propertyEncoder.encoded_property_count - 1;
-  propertyEncoder.property_limit_active = true;
-  if(propertyEncoder.encoded_property_limit > 0)
-    return EncoderState::OpenCBORContainer;
-  else
-    return EncoderState::Error;
-}
-
 CBOREncoder::EncoderState CBOREncoder::handle_FinishAppend(PropertyContainerEncoder & propertyEncoder)
 {
-  /* Restore property message limit to CBOR_ENCODER_NO_PROPERTIES_LIMIT */
-  propertyEncoder.property_limit_active = false;
-
   /* The append process has been successful, so we don't need to try to send this properties set. Cleanup _has_been_appended_but_not_sended flag */
-  PropertyContainer::iterator iter = propertyEncoder.property_container.begin();
-  std::advance(iter, propertyEncoder.current_property_index);
-  int num_appended_properties = 0;
+  PropertyContainer & property_container = propertyEncoder.property_container;
+  size_t const last_property_index = propertyEncoder.current_property_index + propertyEncoder.checked_property_count;
 
-  for(; iter != propertyEncoder.property_container.end(); iter++)
+  for(size_t idx = property_container.nextPending(propertyEncoder.current_property_index);
+      idx < last_property_index;
+      idx = property_container.nextPending(idx + 1))
   {
-    Property * p = * iter;
-    if (num_appended_properties >= propertyEncoder.checked_property_count)
-      break;
-
-    p->appendCompleted();
-    num_appended_properties++;
+    property_container[idx]->appendCompleted();
+    /* Every property in this range has been either sent or found up to date */
+    property_container.clearPending(idx);
   }
 
   /* Advance property index for the next message */
@@ -40,7 +40,11 @@ class CBOREncoder
 public:
     /* encode return > 0 if a property has changed and encodes the changed properties in CBOR format into the provided buffer */
     /* if lightPayload is true the integer identifier of the property will be encoded in the message instead of the property name in order to reduce the size of the message payload*/
-    static CborError encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload = false);
+    /* if baseFields is true the SenML base name and base time fields are used to avoid repeating the composite property names and the absolute timestamps in every record */
+    /* if shortestFloat is true float values are encoded as integers or half floats whenever that is lossless, single precision otherwise */
+    static CborError encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload = false, bool baseFields = false, bool shortestFloat = false);
+    /* encodeRecords encodes the records of a single property without the enclosing array, records encoded this way can be put back to back into the array of a later message */
+    static CborError encodeRecords(Property & property, uint8_t * data, size_t const size, size_t & bytes_encoded, bool shortestFloat = false);
 
 private:
 
@@ -54,9 +58,7 @@ private:
     TryAppend,
     OutOfMemory,
     SkipProperty,
-    TrimAppend,
     CloseCBORContainer,
-    TrimClose,
     FinishAppend,
     SendMessage,
     Error
@@ -64,13 +66,16 @@ private:
 
   struct PropertyContainerEncoder
   {
-    PropertyContainerEncoder(PropertyContainer & _property_container, unsigned int & _current_property_index): property_container(_property_container), current_property_index(_current_property_index) { }
+    PropertyContainerEncoder(PropertyContainer & _property_container, unsigned int & _current_property_index, bool const _base_fields_enabled, bool const _shortest_float_enabled): property_container(_property_container), current_property_index(_current_property_index), base_fields_enabled(_base_fields_enabled), shortest_float_enabled(_shortest_float_enabled) { }
     PropertyContainer & property_container;
     unsigned int & current_property_index;
     int encoded_property_count;
     int checked_property_count;
-    int encoded_property_limit;
-    bool property_limit_active;
+    uint8_t * buffer;
+    size_t buffer_size;
+    bool const base_fields_enabled;
+    bool const shortest_float_enabled;
+    SenMLBaseFields base_fields;
     CborEncoder encoder;
     CborEncoder arrayEncoder;
   };
@@ -80,9 +85,7 @@ private:
   static EncoderState handle_TryAppend(PropertyContainerEncoder & propertyEncoder, bool  & lightPayload);
   static EncoderState handle_OutOfMemory(PropertyContainerEncoder & propertyEncoder);
   static EncoderState handle_SkipProperty(PropertyContainerEncoder & propertyEncoder);
-  static EncoderState handle_TrimAppend(PropertyContainerEncoder & propertyEncoder);
   static EncoderState handle_CloseCBORContainer(PropertyContainerEncoder & propertyEncoder);
-  static EncoderState handle_TrimClose(PropertyContainerEncoder & propertyEncoder);
   static EncoderState handle_FinishAppend(PropertyContainerEncoder & propertyEncoder);
   static EncoderState handle_AdvancePropertyContainer(PropertyContainerEncoder & propertyEncoder);
 
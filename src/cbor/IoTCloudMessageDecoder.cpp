@@ -104,7 +104,8 @@ MessageDecoder::Status TimezoneCommandDownDecoder::decode(CborValue* iter, Messa
 MessageDecoder::Status LastValuesUpdateCommandDecoder::decode(CborValue* iter, Message *msg) {
   LastValuesUpdateCmd * setLv = (LastValuesUpdateCmd *) msg;
 
-  if(!cbor_value_is_byte_string(iter)) {
+  // The last values are decoded in place, chunked byte strings are not contiguous in the message
+  if(!cbor_value_is_byte_string(iter) || !cbor_value_is_length_known(iter)) {
     return MessageDecoder::Status::Error;
   }
 
@@ -112,13 +113,17 @@ MessageDecoder::Status LastValuesUpdateCommandDecoder::decode(CborValue* iter, M
   // we use a support variable to cope with that
   size_t s;
 
-  // NOTE: cbor_value_dup_byte_string calls malloc and assigns it to the second parameter of the call,
-  //       free must be called. Free has to be called only if decode succeeds.
-  //       Read tinyCbor documentation for more information.
-  if (cbor_value_dup_byte_string(iter, &setLv->params.last_values, &s, NULL) != CborNoError) {
+  if (cbor_value_get_string_length(iter, &s) != CborNoError) {
     return MessageDecoder::Status::Error;
   }
 
+  // After advancing, the iterator points right past the content of the byte string
+  CborValue next = *iter;
+  if (cbor_value_advance(&next) != CborNoError) {
+    return MessageDecoder::Status::Error;
+  }
+
+  setLv->params.last_values = cbor_value_get_next_byte(&next) - s;
   setLv->params.length = s;
 
   return MessageDecoder::Status::Complete;
@@ -101,7 +101,8 @@ struct LastValuesBeginCmd {
 struct LastValuesUpdateCmd {
   Command c;
   struct {
-    uint8_t * last_values;
+    /* Points into the buffer of the decoded message, only valid as long as that buffer */
+    uint8_t const * last_values;
     size_t length;
   } params;
 };
@@ -17,8 +17,7 @@
 #if OTA_ENABLED
 #include "OTAInterface.h"
 #include "../OTA.h"
-
-extern "C" unsigned long getTime();
+#include "../../utility/time/TimeService.h"
 
 /******************************************************************************
  * PUBLIC MEMBER FUNCTIONS
@@ -67,7 +66,6 @@ OTACloudProcessInterface::OTACloudProcessInterface(MessageStream *ms)
 , state(Resume)
 , previous_state(Resume)
 , report_last_timestamp(0)
-, report_counter(0)
 , context(nullptr) {
 }
 
@@ -195,7 +193,12 @@ void OTACloudProcessInterface::reportStatus(int32_t state_data) {
     // FIXME handle this case: ota not in progress
     return;
   }
-  uint32_t new_timestamp = getTime();
+  // the report time is in microseconds, reports within the same one are spread by 1us to keep them ordered
+  uint64_t new_timestamp = TimeService.getTimeMillis() * 1000;
+  if(new_timestamp <= report_last_timestamp) {
+    new_timestamp = report_last_timestamp + 1;
+  }
+  report_last_timestamp = new_timestamp;
 
   struct OtaProgressCmdUp msg = {
     OtaProgressCmdUpId,
@@ -203,14 +206,7 @@ void OTACloudProcessInterface::reportStatus(int32_t state_data) {
 
   memcpy(msg.params.id, context->id, ID_SIZE);
   msg.params.state        = state>=0 ? state : State::Fail;
-
-  if(new_timestamp == report_last_timestamp) {
-    msg.params.time       = new_timestamp*1e6 + ++report_counter;
-  } else {
-    msg.params.time       = new_timestamp*1e6;
-    report_counter = 0;
-    report_last_timestamp = new_timestamp;
-  }
+  msg.params.time         = new_timestamp;
 
   msg.params.state_data   = state_data;
 
@@ -171,7 +171,7 @@ private:
   State state, previous_state;
 
   // status report related attributes
-  uint32_t report_last_timestamp, report_counter;
+  uint64_t report_last_timestamp;
 protected:
   struct OtaContext {
     OtaContext(
@@ -16,38 +16,48 @@
 //
 
 #include "Property.h"
+#include "PropertyContainer.h"
+#include "PropertyNameIndex.h"
 
 #undef max
 #undef min
 #include <algorithm>
+#include <vector>
+#include <string.h>
 
 /******************************************************************************
    CTOR/DTOR
  ******************************************************************************/
 Property::Property()
 : _name{""}
-, _min_delta_property{0.0f}
 , _min_time_between_updates_millis{DEFAULT_MIN_TIME_BETWEEN_UPDATES_MILLIS}
-, _permission{Permission::Read}
-, _write_policy{WritePolicy::Auto}
-, _get_time_func{nullptr}
+, _min_delta_property{0.0f}
+, _container_index{0}
+, _timestamp_millis{0}
 , _update_callback_func{nullptr}
 , _on_sync_callback_func{nullptr}
-, _update_policy{UpdatePolicy::OnChange}
-, _has_been_updated_once{false}
-, _has_been_modified_in_callback{false}
-, _has_been_appended_but_not_sended{false}
+, _container{nullptr}
+, _attribute_keys{}
 , _last_updated_millis{0}
 , _update_interval_millis{0}
 , _last_local_change_timestamp{0}
 , _last_cloud_change_timestamp{0}
+, _timestamp{0}
 , _identifier{0}
 , _attributeIdentifier{0}
+, _permission{Permission::Read}
+, _write_policy{WritePolicy::Auto}
+, _update_policy{UpdatePolicy::OnChange}
+, _has_been_updated_once{false}
+, _has_been_modified_in_callback{false}
+, _has_been_appended_but_not_sended{false}
 , _lightPayload{false}
+, _shortest_float{false}
 , _update_requested{false}
 , _encode_timestamp{false}
+, _encode_changed_attributes_only{false}
+, _skip_unchanged_attributes{false}
 , _echo_requested{false}
-, _timestamp{0}
 {
 
 }
@@ -60,13 +70,159 @@ namespace PropertyActions
   const String CLEAR = "\x1b";
 }
 
+/******************************************************************************
+   STATIC MEMBER DEFINITION
+ ******************************************************************************/
+
+CborMapDataArena * Property::_map_data_arena = nullptr;
+SenMLBaseFields * Property::_base_fields = nullptr;
+
+/******************************************************************************
+   INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Slot of name in the open addressing table of interned names, or the empty slot ending its probe sequence */
+static char const * & internedSlot(std::vector<char const *> & table, char const * name, uint32_t const name_hash)
+{
+  size_t const mask = table.size() - 1;
+  size_t i = name_hash & mask;
+  while (table[i] != nullptr && strcmp(table[i], name) != 0)
+    i = (i + 1) & mask;
+  return table[i];
+}
+
+/* Property names are copied once into storage which is never released nor
+ * moved, so that properties only keep a pointer to them. Names registered
+ * more than once share the same storage, they are found through a hash table
+ * hashed like the PropertyNameIndex.
+ */
+static char const * internName(char const * name)
+{
+  static std::vector<char const *> interned_names;
+  static size_t interned_count = 0;
+
+  /* Keep the load factor below 3/4 so that probe sequences stay short */
+  if (((interned_count + 1) * 4) > (interned_names.size() * 3)) {
+    std::vector<char const *> old_names(interned_names.empty() ? 16 : (interned_names.size() * 2), nullptr);
+    old_names.swap(interned_names);
+    for (char const * interned : old_names) {
+      if (interned != nullptr)
+        internedSlot(interned_names, interned, PropertyNameIndex::hash(interned)) = interned;
+    }
+  }
+
+  char const * & slot = internedSlot(interned_names, name, PropertyNameIndex::hash(name));
+  if (slot == nullptr) {
+    size_t const len = strlen(name);
+    char * copy = new char[len + 1];
+    memcpy(copy, name, len + 1);
+    slot = copy;
+    interned_count++;
+  }
+  return slot;
+}
+
+/* Size of a CBOR integer or of the header of a CBOR string with the given length */
+static size_t cborItemSize(uint64_t const value)
+{
+  if (value < 24)          return 1;
+  if (value <= UINT8_MAX)  return 2;
+  if (value <= UINT16_MAX) return 3;
+  if (value <= UINT32_MAX) return 5;
+  return 9;
+}
+
+/* Half precision (IEEE 754 binary16) bits of value, if value is represented exactly */
+static bool floatToHalf(float const value, uint16_t & half)
+{
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  uint16_t const sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+  int const exponent = static_cast<int>((bits >> 23) & 0xFF);
+  uint32_t const mantissa = bits & 0x7FFFFF;
+
+  if (exponent == 0xFF) {
+    /* Infinity and NaN */
+    half = sign | 0x7C00 | ((mantissa != 0) ? 0x0200 : 0);
+    return true;
+  }
+  if (exponent == 0) {
+    /* Zero, single precision subnormals are too small for a half */
+    half = sign;
+    return (mantissa == 0);
+  }
+
+  int const e = exponent - 127;
+  if ((e > 15) || (e < -24))
+    return false;
+
+  /* Half subnormals have 10 - (-14 - e) significant bits instead of 10 */
+  uint32_t const significand = mantissa | 0x800000;
+  int const shift = (e >= -14) ? 13 : (13 - 14 - e);
+  if ((significand & ((1UL << shift) - 1)) != 0)
+    return false;
+
+  if (e >= -14)
+    half = sign | static_cast<uint16_t>((e + 15) << 10) | static_cast<uint16_t>(mantissa >> 13);
+  else
+    half = sign | static_cast<uint16_t>(significand >> shift);
+  return true;
+}
+
+/* Encode value as an integer, a half or a single precision float, whichever is the shortest exact one */
+static CborError encodeShortestFloat(CborEncoder * encoder, float const value)
+{
+  uint16_t half = 0;
+  bool const is_half = floatToHalf(value, half);
+  size_t const float_size = is_half ? 3 : 5;
+
+  /* Negative zero has no integer representation, it falls back to the half */
+  bool const is_negative_zero = (value == 0.0f) && ((half & 0x8000) != 0);
+  if (!is_negative_zero && (value > -4294967296.0f) && (value < 4294967296.0f)) {
+    int64_t const integer = static_cast<int64_t>(value);
+    if (static_cast<float>(integer) == value) {
+      uint64_t const encoded_value = (integer < 0) ? static_cast<uint64_t>(-1 - integer) : static_cast<uint64_t>(integer);
+      if (cborItemSize(encoded_value) <= float_size)
+        return cbor_encode_int(encoder, integer);
+    }
+  }
+
+  if (is_half)
+    return cbor_encode_half_float(encoder, &half);
+  return cbor_encode_float(encoder, value);
+}
+
+/* Encode a SenML time as an integer if it is a whole second, otherwise as a single precision
+ * float if that is within half a millisecond, as a double precision one if it is not.
+ */
+static CborError encodeTime(CborEncoder * encoder, int64_t const seconds, uint16_t const milliseconds)
+{
+  if (milliseconds == 0)
+    return cbor_encode_int(encoder, seconds);
+
+  double const time = static_cast<double>(seconds) + milliseconds / 1000.0;
+  float const time_float = static_cast<float>(time);
+  double const error = static_cast<double>(time_float) - time;
+  if ((error < 0.0005) && (error > -0.0005))
+    return cbor_encode_float(encoder, time_float);
+  return cbor_encode_double(encoder, time);
+}
+
 /******************************************************************************
    PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
-void Property::init(String const name, Permission const permission, GetTimeCallbackFunc func) {
-  _name = name;
+void Property::init(String const name, Permission const permission) {
+  _name = internName(name.c_str());
   _permission = permission;
-  _get_time_func = func;
+  /* Keys cached under a previous name do not apply */
+  _attribute_keys.clear();
+}
+
+void Property::init(String const name, Permission const permission, GetTimeCallbackFunc func) {
+  init(name, permission);
+  if (_container) {
+    _container->setTimeFunc(func);
+  }
 }
 
 Property & Property::onUpdate(UpdateCallbackFunc func) {
@@ -83,17 +239,20 @@ Property & Property::publishOnChange(float const min_delta_property, unsigned lo
   _update_policy = UpdatePolicy::OnChange;
   _min_delta_property = min_delta_property;
   _min_time_between_updates_millis = min_time_between_updates_millis;
+  updateDeadline();
   return (*this);
 }
 
 Property & Property::publishEvery(unsigned long const seconds) {
   _update_policy = UpdatePolicy::TimeInterval;
   _update_interval_millis = (seconds * 1000);
+  updateDeadline();
   return (*this);
 }
 
 Property & Property::publishOnDemand() {
   _update_policy = UpdatePolicy::OnDemand;
+  updateDeadline();
   return (*this);
 }
 
@@ -103,6 +262,12 @@ Property & Property::encodeTimestamp()
   return (*this);
 }
 
+Property & Property::encodeChangedAttributesOnly()
+{
+  _encode_changed_attributes_only = true;
+  return (*this);
+}
+
 Property & Property::writeOnChange()
 {
   _write_policy = WritePolicy::Auto;
@@ -118,6 +283,13 @@ Property & Property::writeOnDemand()
 void Property::setTimestamp(unsigned long const timestamp)
 {
   _timestamp = timestamp;
+  _timestamp_millis = 0;
+}
+
+void Property::setTimestampMillis(uint64_t const timestamp_ms)
+{
+  _timestamp = static_cast<unsigned long>(timestamp_ms / 1000);
+  _timestamp_millis = static_cast<uint16_t>(timestamp_ms % 1000);
 }
 
 bool Property::shouldBeUpdated() {
@@ -148,14 +320,36 @@ bool Property::shouldBeUpdated() {
   }
 }
 
+void Property::updateDeadline() {
+  if (!_container) {
+    return;
+  }
+  /* Time interval properties are due when the interval elapses, OnChange
+   * properties held back by the rate limit are due when the limit expires.
+   */
+  if (isReadableByCloud()) {
+    if (_update_policy == UpdatePolicy::TimeInterval) {
+      _container->setDeadline(_container_index, _last_updated_millis + _update_interval_millis);
+      return;
+    }
+    if (_update_policy == UpdatePolicy::OnChange && isDifferentFromCloud()) {
+      _container->setDeadline(_container_index, _last_updated_millis + _min_time_between_updates_millis);
+      return;
+    }
+  }
+  _container->clearDeadline(_container_index);
+}
+
 void Property::requestUpdate()
 {
   _update_requested = true;
+  markPending();
 }
 
 void Property::provideEcho()
 {
   _echo_requested = true;
+  markPending();
 }
 
 void Property::appendCompleted()
@@ -171,6 +365,7 @@ void Property::execCallbackOnChange() {
   }
   if (isDifferentFromCloud()) {
     _has_been_modified_in_callback = true;
+    markPending();
   }
 }
 
@@ -180,10 +375,15 @@ void Property::execCallbackOnSync() {
   }
 }
 
-CborError Property::append(CborEncoder *encoder, bool lightPayload) {
+CborError Property::append(CborEncoder *encoder, bool lightPayload, bool shortestFloat, SenMLBaseFields * base) {
   _lightPayload = lightPayload;
+  _shortest_float = shortestFloat;
   _attributeIdentifier = 0;
-  CHECK_CBOR(appendAttributesToCloud(encoder));
+  _skip_unchanged_attributes = skipUnchangedAttributes();
+  _base_fields = base;
+  CborError const append_error = appendAttributesToCloud(encoder);
+  _base_fields = nullptr;
+  CHECK_CBOR(append_error);
   fromLocalToCloud();
   _has_been_updated_once = true;
   _has_been_modified_in_callback = false;
@@ -191,64 +391,108 @@ CborError Property::append(CborEncoder *encoder, bool lightPayload) {
   _echo_requested = false;
   _has_been_appended_but_not_sended = true;
   _last_updated_millis = millis();
+  markPending();
+  updateDeadline();
   return CborNoError;
 }
 
-CborError Property::appendAttribute(bool value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
-  {
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BooleanValue)));
-    CHECK_CBOR(cbor_encode_boolean(&mapEncoder, value));
+CborError Property::appendAttribute(bool value, char const * attributeName, CborEncoder *encoder, bool const changed) {
+  if (skipAttribute(attributeName, changed)) {
     return CborNoError;
-  }, encoder);
+  }
+  CborEncoder mapEncoder;
+  CHECK_CBOR(appendAttributeName(attributeName, encoder, &mapEncoder));
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BooleanValue)));
+  CHECK_CBOR(cbor_encode_boolean(&mapEncoder, value));
+  return appendAttributeEnd(encoder, &mapEncoder);
 }
 
-CborError Property::appendAttribute(int value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
-  {
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, value));
+CborError Property::appendAttribute(int value, char const * attributeName, CborEncoder *encoder, bool const changed) {
+  if (skipAttribute(attributeName, changed)) {
     return CborNoError;
-  }, encoder);
+  }
+  CborEncoder mapEncoder;
+  CHECK_CBOR(appendAttributeName(attributeName, encoder, &mapEncoder));
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, value));
+  return appendAttributeEnd(encoder, &mapEncoder);
 }
 
-CborError Property::appendAttribute(unsigned int value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
-  {
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, value));
+CborError Property::appendAttribute(unsigned int value, char const * attributeName, CborEncoder *encoder, bool const changed) {
+  if (skipAttribute(attributeName, changed)) {
     return CborNoError;
-  }, encoder);
+  }
+  CborEncoder mapEncoder;
+  CHECK_CBOR(appendAttributeName(attributeName, encoder, &mapEncoder));
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, value));
+  return appendAttributeEnd(encoder, &mapEncoder);
 }
 
-CborError Property::appendAttribute(float value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
-  {
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
-    CHECK_CBOR(cbor_encode_float(&mapEncoder, value));
+CborError Property::appendAttribute(float value, char const * attributeName, CborEncoder *encoder, bool const changed) {
+  if (skipAttribute(attributeName, changed)) {
     return CborNoError;
-  }, encoder);
+  }
+  CborEncoder mapEncoder;
+  CHECK_CBOR(appendAttributeName(attributeName, encoder, &mapEncoder));
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
+  if (_shortest_float) {
+    CHECK_CBOR(encodeShortestFloat(&mapEncoder, value));
+  } else {
+    CHECK_CBOR(cbor_encode_float(&mapEncoder, value));
+  }
+  return appendAttributeEnd(encoder, &mapEncoder);
 }
 
-CborError Property::appendAttribute(String value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
-  {
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::StringValue)));
-    CHECK_CBOR(cbor_encode_text_stringz(&mapEncoder, value.c_str()));
+CborError Property::appendAttribute(String const & value, char const * attributeName, CborEncoder *encoder, bool const changed) {
+  if (skipAttribute(attributeName, changed)) {
     return CborNoError;
-  }, encoder);
+  }
+  CborEncoder mapEncoder;
+  CHECK_CBOR(appendAttributeName(attributeName, encoder, &mapEncoder));
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::StringValue)));
+  CHECK_CBOR(cbor_encode_text_stringz(&mapEncoder, value.c_str()));
+  return appendAttributeEnd(encoder, &mapEncoder);
 }
 
-CborError Property::appendAttributeName(String attributeName, std::function<CborError (CborEncoder& mapEncoder)>appendValue, CborEncoder *encoder)
+/* Open the map of an attribute and encode its name, the caller encodes the value and closes it with appendAttributeEnd */
+CborError Property::appendAttributeName(char const * attributeName, CborEncoder *encoder, CborEncoder *mapEncoder)
 {
-  if (attributeName != "") {
+  if (attributeName[0] != '\0') {
     // when the attribute name string is not empty, the attribute identifier is incremented in order to be encoded in the message if the _lightPayload flag is set
     _attributeIdentifier++;
   }
-  CborEncoder mapEncoder;
-  unsigned int num_map_properties = _encode_timestamp ? 3 : 2;
-  CHECK_CBOR(cbor_encoder_create_map(encoder, &mapEncoder, num_map_properties));
-  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Name)));
+  SenMLBaseFields * base = _base_fields;
+  bool const is_composite = (attributeName[0] != '\0');
+  /* Composite properties share the "name:" base name, other properties need it to be cleared */
+  bool const write_base_name = (base != nullptr) && !_lightPayload && (base->base_name != (is_composite ? this : nullptr));
+  bool const write_base_time = (base != nullptr) && _encode_timestamp && !base->base_time_set;
+
+  unsigned int num_map_properties = 2;
+  if (_encode_timestamp) num_map_properties++;
+  if (write_base_name)   num_map_properties++;
+  if (write_base_time)   num_map_properties++;
+  CHECK_CBOR(cbor_encoder_create_map(encoder, mapEncoder, num_map_properties));
+
+  if (write_base_name) {
+    CHECK_CBOR(cbor_encode_int(mapEncoder, static_cast<int>(CborIntegerMapKey::BaseName)));
+    if (is_composite) {
+      CHECK_CBOR(appendCompositeName(mapEncoder, ""));
+      base->base_name = this;
+    } else {
+      CHECK_CBOR(cbor_encode_text_stringz(mapEncoder, ""));
+      base->base_name = nullptr;
+    }
+  }
+  if (write_base_time) {
+    /* The time of the following records is encoded relative to the first one */
+    CHECK_CBOR(cbor_encode_int(mapEncoder, static_cast<int>(CborIntegerMapKey::BaseTime)));
+    CHECK_CBOR(cbor_encode_uint(mapEncoder, _timestamp));
+    base->base_time_set = true;
+    base->base_time = _timestamp;
+  }
+
+  CHECK_CBOR(cbor_encode_int(mapEncoder, static_cast<int>(CborIntegerMapKey::Name)));
 
   // if _lightPayload is true, the property and attribute identifiers will be encoded instead of the property name
   if (_lightPayload)
@@ -257,113 +501,214 @@ CborError Property::appendAttributeName(String attributeName, std::function<Cbor
     int completeIdentifier = _attributeIdentifier * 256;
     // the least significant byte of the identifier to be encoded represent the attribute identifier
     completeIdentifier += _identifier;
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, completeIdentifier));
+    CHECK_CBOR(cbor_encode_int(mapEncoder, completeIdentifier));
+  }
+  else if (base != nullptr && is_composite)
+  {
+    /* The "name:" prefix is provided by the base name */
+    CHECK_CBOR(cbor_encode_text_stringz(mapEncoder, attributeName));
+  }
+  else if (is_composite)
+  {
+    CHECK_CBOR(appendAttributeKey(mapEncoder, attributeName));
   }
   else
   {
-    String completeName = _name;
-    if (attributeName != "") {
-      completeName += ":" + attributeName;
-    }
-    CHECK_CBOR(cbor_encode_text_stringz(&mapEncoder, completeName.c_str()));
+    CHECK_CBOR(cbor_encode_text_stringz(mapEncoder, _name));
+  }
+  return CborNoError;
+}
+
+/* Encode "name:attribute", composed on the stack since names are short enough in practice */
+CborError Property::appendCompositeName(CborEncoder *mapEncoder, char const * attributeName)
+{
+  size_t const name_len = strlen(_name);
+  size_t const attribute_len = strlen(attributeName);
+  if ((name_len + 1 + attribute_len) <= MAX_KEY_LENGTH) {
+    char key[MAX_KEY_LENGTH + 1];
+    memcpy(key, _name, name_len);
+    key[name_len] = ':';
+    memcpy(key + name_len + 1, attributeName, attribute_len + 1);
+    CHECK_CBOR(cbor_encode_text_string(mapEncoder, key, name_len + 1 + attribute_len));
+  } else {
+    String const long_key = String(_name) + ":" + attributeName;
+    CHECK_CBOR(cbor_encode_text_stringz(mapEncoder, long_key.c_str()));
+  }
+  return CborNoError;
+}
+
+/* The "name:attribute" key is interned the first time the attribute is encoded and reused by
+ * all the following encodings.
+ */
+CborError Property::appendAttributeKey(CborEncoder *mapEncoder, char const * attributeName)
+{
+  size_t const key_idx = _attributeIdentifier - 1;
+  if (key_idx >= MAX_CACHED_KEYS) {
+    return appendCompositeName(mapEncoder, attributeName);
+  }
+  if (_attribute_keys[key_idx] == nullptr) {
+    String const key = String(_name) + ":" + attributeName;
+    _attribute_keys[key_idx] = internName(key.c_str());
   }
-  /* Encode the value */
-  CHECK_CBOR(appendValue(mapEncoder));
+  CHECK_CBOR(cbor_encode_text_stringz(mapEncoder, _attribute_keys[key_idx]));
+  return CborNoError;
+}
 
+CborError Property::appendAttributeEnd(CborEncoder *encoder, CborEncoder *mapEncoder)
+{
   /* Encode the timestamp if that has been required. */
   if(_encode_timestamp)
   {
-    CHECK_CBOR(cbor_encode_int (&mapEncoder, static_cast<int>(CborIntegerMapKey::Time)));
-    CHECK_CBOR(cbor_encode_uint(&mapEncoder, _timestamp));
+    CHECK_CBOR(cbor_encode_int (mapEncoder, static_cast<int>(CborIntegerMapKey::Time)));
+    if (_base_fields != nullptr) {
+      CHECK_CBOR(encodeTime(mapEncoder, static_cast<long>(_timestamp - _base_fields->base_time), _timestamp_millis));
+    } else {
+      CHECK_CBOR(encodeTime(mapEncoder, _timestamp, _timestamp_millis));
+    }
   }
   /* Close the container */
-  CHECK_CBOR(cbor_encoder_close_container(encoder, &mapEncoder));
+  CHECK_CBOR(cbor_encoder_close_container(encoder, mapEncoder));
   return CborNoError;
 }
 
-void Property::setAttributesFromCloud(std::list<CborMapData> * map_data_list) {
-  _map_data_list = map_data_list;
+size_t Property::attributeSizeHint(bool /* value */, char const * attributeName, bool const lightPayload, bool const changed) const {
+  return attributeNameSizeHint(attributeName, 1, lightPayload, changed);
+}
+
+size_t Property::attributeSizeHint(int value, char const * attributeName, bool const lightPayload, bool const changed) const {
+  /* Negative integers are encoded as -1 - value */
+  uint64_t const encoded_value = (value < 0) ? static_cast<uint64_t>(-1 - static_cast<int64_t>(value)) : static_cast<uint64_t>(value);
+  return attributeNameSizeHint(attributeName, cborItemSize(encoded_value), lightPayload, changed);
+}
+
+size_t Property::attributeSizeHint(unsigned int value, char const * attributeName, bool const lightPayload, bool const changed) const {
+  return attributeNameSizeHint(attributeName, cborItemSize(value), lightPayload, changed);
+}
+
+size_t Property::attributeSizeHint(float /* value */, char const * attributeName, bool const lightPayload, bool const changed) const {
+  /* Floats are encoded in single precision, the shortest float encoding can only take less */
+  return attributeNameSizeHint(attributeName, 1 + sizeof(float), lightPayload, changed);
+}
+
+size_t Property::attributeSizeHint(String const & value, char const * attributeName, bool const lightPayload, bool const changed) const {
+  size_t const length = value.length();
+  return attributeNameSizeHint(attributeName, cborItemSize(length) + length, lightPayload, changed);
+}
+
+size_t Property::attributeNameSizeHint(char const * attributeName, size_t const value_size, bool const lightPayload, bool const changed) const
+{
+  if (!changed && _skip_unchanged_attributes) {
+    return 0;
+  }
+
+  /* Mirrors appendAttributeName: map header, name key and value key take one byte each */
+  size_t size = 3 + value_size;
+
+  if (lightPayload) {
+    /* Attributes move the identifier above 255, it stays below 65536 since there are less than 256 attributes */
+    size += (attributeName[0] != '\0') ? cborItemSize(256) : cborItemSize(_identifier);
+  } else {
+    size_t length = strlen(_name);
+    if (attributeName[0] != '\0') {
+      length += 1 + strlen(attributeName);
+    }
+    size += cborItemSize(length) + length;
+  }
+
+  if (_encode_timestamp) {
+    /* A fraction of second is at most a double precision float */
+    size += 1 + ((_timestamp_millis != 0) ? 9 : cborItemSize(_timestamp));
+  }
+  return size;
+}
+
+size_t Property::appendSizeHint(bool const lightPayload)
+{
+  _skip_unchanged_attributes = skipUnchangedAttributes();
+  return encodedSizeHint(lightPayload);
+}
+
+/* Unchanged attributes are left out, still taking up their light payload identifier */
+bool Property::skipAttribute(char const * attributeName, bool const changed)
+{
+  if (changed || !_skip_unchanged_attributes) {
+    return false;
+  }
+  if (attributeName[0] != '\0') {
+    _attributeIdentifier++;
+  }
+  return true;
+}
+
+void Property::setAttributesFromCloud(CborMapDataArena * map_data_arena) {
+  _map_data_arena = map_data_arena;
   _attributeIdentifier = 0;
   setAttributesFromCloud();
+  markPending();
 }
 
-void Property::setAttribute(bool& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
-    // Manage the case to have boolean values received as integers 0/1
-    if (md.bool_val.isSet()) {
-      value = md.bool_val.get();
-    } else if (md.val.isSet()) {
-      if (md.val.get() == 0) {
-        value = false;
-      } else if (md.val.get() == 1) {
-        value = true;
-      } else {
-        /* This should not happen. Leave the previous value */
-      }
+void Property::setAttribute(bool& value, char const * attributeName) {
+  CborMapData const * md = findAttribute(attributeName);
+  if (md == nullptr) {
+    return;
+  }
+  // Manage the case to have boolean values received as integers 0/1
+  if (md->bool_val.isSet()) {
+    value = md->bool_val.get();
+  } else if (md->val.isSet()) {
+    if (md->val.get() == 0) {
+      value = false;
+    } else if (md->val.get() == 1) {
+      value = true;
+    } else {
+      /* This should not happen. Leave the previous value */
     }
-  });
+  }
 }
 
-void Property::setAttribute(int& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
-    value = md.val.get();
-  });
+void Property::setAttribute(int& value, char const * attributeName) {
+  CborMapData const * md = findAttribute(attributeName);
+  if (md != nullptr) {
+    value = md->val.get();
+  }
 }
 
-void Property::setAttribute(unsigned int& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
-    value = md.val.get();
-  });
+void Property::setAttribute(unsigned int& value, char const * attributeName) {
+  CborMapData const * md = findAttribute(attributeName);
+  if (md != nullptr) {
+    value = md->val.get();
+  }
 }
 
-void Property::setAttribute(float& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
-    value = md.val.get();
-  });
+void Property::setAttribute(float& value, char const * attributeName) {
+  CborMapData const * md = findAttribute(attributeName);
+  if (md != nullptr) {
+    value = md->val.get();
+  }
 }
 
-void Property::setAttribute(String& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
-    value = md.str_val.get();
-  });
+void Property::setAttribute(String& value, char const * attributeName) {
+  CborMapData const * md = findAttribute(attributeName);
+  if (md != nullptr) {
+    md->str_val.get().copyTo(value);
+  }
 }
 
-void Property::setAttribute(String attributeName, std::function<void (CborMapData & md)>setValue)
+CborMapData const * Property::findAttribute(char const * attributeName)
 {
-  if (attributeName != "") {
+  if (attributeName[0] != '\0') {
     _attributeIdentifier++;
   }
 
-  std::for_each(_map_data_list->begin(),
-                _map_data_list->end(),
-                [this, attributeName, setValue](CborMapData & map)
-                {
-                  if (map.light_payload.isSet() && map.light_payload.get())
-                  {
-                    // if a light payload is detected, the attribute identifier is retrieved from the cbor map and the corresponding attribute is updated
-                    int attid = map.attribute_identifier.get();
-                    if (attid == _attributeIdentifier) {
-                      setValue(map);
-                      return;
-                    }
-                  }
-                  else
-                  {
-                    // if a normal payload is detected, the name of the attribute to be updated is extracted directly from the cbor map
-                    String an = map.attribute_name.get();
-                    if (an == attributeName) {
-                      setValue(map);
-                      return;
-                    }
-                  }
-                });
+  /* Attributes are numbered from 1, a property without attributes has identifier 0 */
+  size_t const idx = (_attributeIdentifier > 0) ? (_attributeIdentifier - 1) : 0;
+  return _map_data_arena->find(attributeName, _attributeIdentifier, idx);
 }
 
 void Property::updateLocalTimestamp() {
-  if (isReadableByCloud()) {
-    if (_get_time_func) {
-      _last_local_change_timestamp = _get_time_func();
-    }
+  markPending();
+  if (isReadableByCloud() && _container) {
+    _last_local_change_timestamp = _container->currentTime();
   }
 }
 
@@ -384,7 +729,92 @@ unsigned long Property::getLastLocalChangeTimestamp() {
 }
 
 void Property::setIdentifier(int identifier) {
-  _identifier = identifier;
+  /* 16 bit like the container index, so automatic identifiers can not wrap around */
+  _identifier = static_cast<uint16_t>(identifier);
+}
+
+void Property::setContainer(PropertyContainer * container, unsigned int index) {
+  _container = container;
+  _container_index = index;
+  markPending();
+  /* Wrapped primitives and other types can be changed without notice and are checked on every update */
+  _container->setPolled(_container_index, !notifiesLocalChanges() && isReadableByCloud());
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+/* Only changes of a property already known to the cloud can be sent as a subset of its
+ * attributes. Echoes, requested updates and repeated appends send all of them.
+ */
+bool Property::skipUnchangedAttributes()
+{
+  return _encode_changed_attributes_only &&
+         _has_been_updated_once &&
+         !_has_been_appended_but_not_sended &&
+         !_echo_requested &&
+         !_update_requested &&
+         isDifferentFromCloud();
+}
+
+void Property::markPending() {
+  if (_container) {
+    _container->markPending(_container_index);
+  }
+}
+
+/******************************************************************************
+   CBOR MAP DATA ARENA
+ ******************************************************************************/
+
+bool CborMapDataArena::add(CborMapData const & map_data) {
+  bool const light_payload = isLightPayload(map_data);
+
+  /* The last value received for an attribute wins */
+  for (size_t i = 0; i < _size; i++) {
+    if (isLightPayload(_records[i]) != light_payload) {
+      continue;
+    }
+    bool const same_attribute = light_payload ?
+      (_records[i].attribute_identifier.get() == map_data.attribute_identifier.get()) :
+      (_records[i].attribute_name.get() == map_data.attribute_name.get());
+    if (same_attribute) {
+      _records[i] = map_data;
+      return true;
+    }
+  }
+
+  if (_size == CAPACITY) {
+    return false;
+  }
+  _records[_size++] = map_data;
+  return true;
+}
+
+CborMapData const * CborMapDataArena::find(char const * attributeName, int const attributeIdentifier, size_t const idx) const {
+  if ((idx < _size) && isAttribute(_records[idx], attributeName, attributeIdentifier)) {
+    return &_records[idx];
+  }
+  for (size_t i = 0; i < _size; i++) {
+    if (isAttribute(_records[i], attributeName, attributeIdentifier)) {
+      return &_records[i];
+    }
+  }
+  return nullptr;
+}
+
+bool CborMapDataArena::isLightPayload(CborMapData const & map_data) {
+  return map_data.light_payload.isSet() && map_data.light_payload.get();
+}
+
+bool CborMapDataArena::isAttribute(CborMapData const & map_data, char const * attributeName, int const attributeIdentifier) {
+  if (isLightPayload(map_data)) {
+    // if a light payload is detected, the attribute identifier is retrieved from the cbor map
+    return map_data.attribute_identifier.get() == attributeIdentifier;
+  }
+  // if a normal payload is detected, the name of the attribute is extracted directly from the cbor map
+  return map_data.attribute_name.get() == attributeName;
 }
 
 /******************************************************************************
@@ -37,6 +37,8 @@
 
 #include <Arduino_TinyCBOR.h>
 
+#include "StringView.h"
+
 /******************************************************************************
    CONST
  ******************************************************************************/
@@ -77,7 +79,7 @@ class MapEntry {
       _entry = entry;
       _is_set = true;
     }
-    inline T const get() const {
+    inline T const & get() const {
       return _entry;
     }
 
@@ -95,25 +97,74 @@ class MapEntry {
 
 };
 
+class Property;
+class PropertyContainer;
+
+/* The text entries are views into the payload being decoded */
 class CborMapData {
 
   public:
-    MapEntry<int>    base_version;
-    MapEntry<String> base_name;
-    MapEntry<double> base_time;
-    MapEntry<String> name;
-    MapEntry<int>    name_identifier;
-    MapEntry<bool>   light_payload;
-    MapEntry<String> attribute_name;
-    MapEntry<int>    attribute_identifier;
-    MapEntry<int>    property_identifier;
-    MapEntry<double> val;
-    MapEntry<String> str_val;
-    MapEntry<bool>   bool_val;
-    MapEntry<double> time;
+    MapEntry<int>        base_version;
+    MapEntry<StringView> base_name;
+    MapEntry<double>     base_time;
+    MapEntry<StringView> name;
+    MapEntry<Property *> property;
+    MapEntry<bool>       light_payload;
+    MapEntry<StringView> attribute_name;
+    MapEntry<int>        attribute_identifier;
+    MapEntry<double>     val;
+    MapEntry<StringView> str_val;
+    MapEntry<bool>       bool_val;
+    MapEntry<double>     time;
+};
+
+/* Fixed capacity store of the records decoded for the property being updated, reused
+ * across decode calls so that decoding does not allocate. A record replaces the one
+ * previously stored for the same attribute, therefore the capacity only needs to
+ * cover the property with the most attributes.
+ */
+class CborMapDataArena {
+
+  public:
+    /* CloudTelevision: swi, vol, mut, pbc, inp, cha */
+    static size_t const CAPACITY = 6;
+
+    CborMapDataArena() : _size{0} { }
+
+    inline void   clear()       { _size = 0; }
+    inline size_t size () const { return _size; }
+    inline CborMapData const & operator[](size_t const idx) const { return _records[idx]; }
+
+    /* Return false if the arena is full and the record is dropped */
+    bool add(CborMapData const & map_data);
+    /* Return the record of an attribute, idx is where it is expected if the
+     * attributes were received in the order the property sets them.
+     */
+    CborMapData const * find(char const * attributeName, int const attributeIdentifier, size_t const idx) const;
+
+  private:
+    CborMapData _records[CAPACITY];
+    size_t _size;
+
+    static bool isLightPayload(CborMapData const & map_data);
+    static bool isAttribute(CborMapData const & map_data, char const * attributeName, int const attributeIdentifier);
+};
+
+/* SenML base fields already written in the message being encoded, see RFC 8428 section 4.1.
+ * Base fields apply to all the following records of the message until they are overridden.
+ */
+class SenMLBaseFields {
+
+  public:
+    SenMLBaseFields() : base_name(nullptr), base_time_set(false), base_time(0) { }
+
+    /* Property whose "name:" prefix is the current base name, nullptr if there is none */
+    Property const * base_name;
+    bool             base_time_set;
+    unsigned long    base_time;
 };
 
-enum class Permission {
+enum class Permission : uint8_t {
   Read, Write, ReadWrite
 };
 
@@ -121,17 +172,16 @@ enum class Type {
   Bool, Int, Float, String
 };
 
-enum class UpdatePolicy {
+enum class UpdatePolicy : uint8_t {
   OnChange, TimeInterval, OnDemand
 };
 
-enum class WritePolicy {
+enum class WritePolicy : uint8_t {
   Auto, Manual
 };
 
 typedef void(*UpdateCallbackFunc)(void);
 typedef unsigned long(*GetTimeCallbackFunc)();
-class Property;
 typedef void(*OnSyncCallbackFunc)(Property &);
 
 /******************************************************************************
@@ -143,6 +193,9 @@ class Property
   public:
     Property();
     virtual ~Property() {}
+    /* Local changes are timestamped with the time source of the container the property is added to */
+    void init(String const name, Permission const permission);
+    /* func becomes the time source of the container the property already belongs to, see addPropertyToContainer() */
     void init(String const name, Permission const permission, GetTimeCallbackFunc func);
 
     /* Composable configuration of the Property class */
@@ -152,10 +205,16 @@ class Property
     Property & publishEvery(unsigned long const seconds);
     Property & publishOnDemand();
     Property & encodeTimestamp();
+    Property & encodeChangedAttributesOnly();
     Property & writeOnChange();
     Property & writeOnDemand();
 
+    /* Copy of the name, kept for compatibility. It allocates on every call, the library uses nameCStr() */
     inline String name() const {
+      return String(_name);
+    }
+    /* Interned name, use it instead of name() where a copy is not needed */
+    inline char const * nameCStr() const {
       return _name;
     }
     inline int identifier() const {
@@ -170,8 +229,16 @@ class Property
     inline bool   isWritableOnChange() const {
       return _write_policy == WritePolicy::Auto;
     }
+    inline bool   isTimestampEncoded() const {
+      return _encode_timestamp;
+    }
+    inline unsigned long timestamp() const {
+      return _timestamp;
+    }
 
     void setTimestamp(unsigned long const timestamp);
+    /* Millisecond timestamp, a fraction of second is encoded as a fractional SenML time */
+    void setTimestampMillis(uint64_t const timestamp_ms);
     bool shouldBeUpdated();
     void requestUpdate();
     void appendCompleted();
@@ -183,70 +250,149 @@ class Property
     unsigned long getLastCloudChangeTimestamp();
     unsigned long getLastLocalChangeTimestamp();
     void setIdentifier(int identifier);
+    void setContainer(PropertyContainer * container, unsigned int index);
+    void updateDeadline();
 
     void updateLocalTimestamp();
-    CborError append(CborEncoder * encoder, bool lightPayload);
-    CborError appendAttribute(bool value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(int value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(unsigned int value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(float value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(String value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttributeName(String attributeName, std::function<CborError (CborEncoder& mapEncoder)>f, CborEncoder *encoder);
-    void setAttribute(String attributeName, std::function<void (CborMapData & md)>setValue);
-    void setAttributesFromCloud(std::list<CborMapData> * map_data_list);
-    void setAttribute(bool& value, String attributeName = "");
-    void setAttribute(int& value, String attributeName = "");
-    void setAttribute(unsigned int& value, String attributeName = "");
-    void setAttribute(float& value, String attributeName = "");
-    void setAttribute(String& value, String attributeName = "");
+    /* If shortestFloat is true floats are encoded as integers or half floats whenever that is exact.
+     * If base is provided the records use the SenML base name and base time fields tracked there.
+     */
+    CborError append(CborEncoder * encoder, bool lightPayload, bool shortestFloat = false, SenMLBaseFields * base = nullptr);
+    CborError appendAttribute(bool value, char const * attributeName = "", CborEncoder *encoder = nullptr, bool const changed = true);
+    CborError appendAttribute(int value, char const * attributeName = "", CborEncoder *encoder = nullptr, bool const changed = true);
+    CborError appendAttribute(unsigned int value, char const * attributeName = "", CborEncoder *encoder = nullptr, bool const changed = true);
+    CborError appendAttribute(float value, char const * attributeName = "", CborEncoder *encoder = nullptr, bool const changed = true);
+    CborError appendAttribute(String const & value, char const * attributeName = "", CborEncoder *encoder = nullptr, bool const changed = true);
+    CborError appendAttributeName(char const * attributeName, CborEncoder *encoder, CborEncoder *mapEncoder);
+    CborError appendAttributeEnd(CborEncoder *encoder, CborEncoder *mapEncoder);
+    CborError appendCompositeName(CborEncoder *mapEncoder, char const * attributeName);
+    CborError appendAttributeKey(CborEncoder *mapEncoder, char const * attributeName);
+    size_t attributeSizeHint(bool value, char const * attributeName, bool const lightPayload, bool const changed = true) const;
+    size_t attributeSizeHint(int value, char const * attributeName, bool const lightPayload, bool const changed = true) const;
+    size_t attributeSizeHint(unsigned int value, char const * attributeName, bool const lightPayload, bool const changed = true) const;
+    size_t attributeSizeHint(float value, char const * attributeName, bool const lightPayload, bool const changed = true) const;
+    size_t attributeSizeHint(String const & value, char const * attributeName, bool const lightPayload, bool const changed = true) const;
+    size_t attributeNameSizeHint(char const * attributeName, size_t const value_size, bool const lightPayload, bool const changed) const;
+    bool skipAttribute(char const * attributeName, bool const changed);
+    /* Size hint of the next append(), unchanged attributes are left out if that applies to it */
+    size_t appendSizeHint(bool const lightPayload);
+    CborMapData const * findAttribute(char const * attributeName);
+    void setAttributesFromCloud(CborMapDataArena * map_data_arena);
+    void setAttribute(bool& value, char const * attributeName = "");
+    void setAttribute(int& value, char const * attributeName = "");
+    void setAttribute(unsigned int& value, char const * attributeName = "");
+    void setAttribute(float& value, char const * attributeName = "");
+    void setAttribute(String& value, char const * attributeName = "");
 
     virtual bool isDifferentFromCloud() = 0;
     virtual void fromCloudToLocal() = 0;
     virtual void fromLocalToCloud() = 0;
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) = 0;
     virtual void setAttributesFromCloud() = 0;
+    /* Number of bytes append() adds to the message, 0 if it can not be predicted */
+    virtual size_t encodedSizeHint(bool const /* lightPayload */) const {
+      return 0;
+    }
     virtual bool isPrimitive() {
       return false;
     };
+    /* Return true if every change of the local value calls updateLocalTimestamp(), which
+     * flags the property as pending. Other properties, e.g. user defined types, are checked
+     * on every update like wrapped primitives.
+     */
+    virtual bool notifiesLocalChanges() const {
+      return false;
+    }
 
     static unsigned long const DEFAULT_MIN_TIME_BETWEEN_UPDATES_MILLIS = 500; /* Data rate throttled to 2 Hz */
 
   protected:
+    /* Interned when the property is initialized, immutable afterwards */
+    char const *       _name;
     /* Variables used for UpdatePolicy::OnChange */
-    String             _name;
-    float              _min_delta_property;
     unsigned long      _min_time_between_updates_millis;
+    float              _min_delta_property;
 
   private:
-    Permission         _permission;
-    WritePolicy        _write_policy;
-    GetTimeCallbackFunc _get_time_func;
+    /* Placed first to fill the padding after _min_delta_property on 64 bit targets */
+    uint16_t           _container_index;
+    /* Milliseconds of _timestamp */
+    uint16_t           _timestamp_millis;
+
+    /* Longest "name:attribute" key composed without heap allocation */
+    static size_t const MAX_KEY_LENGTH = 63;
+    /* Attributes of a multi-value property whose "name:attribute" key is cached */
+    static size_t const MAX_CACHED_KEYS = 8;
+
+    /* Interned "name:attribute" keys of multi-value properties, indexed by attribute identifier.
+     * The table is owned by the property, a copy starts with an empty one since it may be
+     * registered under another name.
+     */
+    class AttributeKeyCache
+    {
+    public:
+      AttributeKeyCache() : _keys{nullptr} { }
+      AttributeKeyCache(AttributeKeyCache const &) : _keys{nullptr} { }
+      AttributeKeyCache & operator = (AttributeKeyCache const &) { clear(); return *this; }
+      ~AttributeKeyCache() { clear(); }
+
+      inline void clear() { delete[] _keys; _keys = nullptr; }
+      /* Slot of the key of attribute idx, allocating the table on first use */
+      inline char const * & operator [] (size_t const idx) {
+        if (_keys == nullptr) {
+          _keys = new char const * [MAX_CACHED_KEYS]();
+        }
+        return _keys[idx];
+      }
+
+    private:
+      char const ** _keys;
+    };
+
+    /* Members are ordered by size to avoid padding, this object exists once per property */
+    /* Map data of the property being updated from the cloud, only valid while decoding */
+    static CborMapDataArena * _map_data_arena;
+    /* Base fields of the message being encoded, only valid while appending */
+    static SenMLBaseFields * _base_fields;
+
     UpdateCallbackFunc _update_callback_func;
     OnSyncCallbackFunc _on_sync_callback_func;
-
-    UpdatePolicy       _update_policy;
-    bool               _has_been_updated_once,
-                       _has_been_modified_in_callback,
-                       _has_been_appended_but_not_sended;
+    /* Container notified whenever the property may need to be sent to the cloud */
+    PropertyContainer * _container;
+    AttributeKeyCache  _attribute_keys;
     /* Variables used for UpdatePolicy::TimeInterval */
     unsigned long      _last_updated_millis,
                        _update_interval_millis;
     /* Variables used for reconnection sync*/
     unsigned long      _last_local_change_timestamp;
     unsigned long      _last_cloud_change_timestamp;
-    std::list<CborMapData> * _map_data_list;
-    /* Store the identifier of the property in the array list */
-    int                _identifier;
-    int                _attributeIdentifier;
+    unsigned long      _timestamp;
+    /* Store the identifier of the property in the array list, light payloads use its 8 least significant bits */
+    uint16_t           _identifier;
+    uint8_t            _attributeIdentifier;
+    Permission         _permission;
+    WritePolicy        _write_policy;
+    UpdatePolicy       _update_policy;
+    bool               _has_been_updated_once : 1;
+    bool               _has_been_modified_in_callback : 1;
+    bool               _has_been_appended_but_not_sended : 1;
     /* Indicates if the property shall be encoded using the identifier instead of the name */
-    bool               _lightPayload;
+    bool               _lightPayload : 1;
+    /* Indicates if floats shall be encoded with the shortest exact representation */
+    bool               _shortest_float : 1;
     /* Indicates whether a property update has been requested in case of the OnDemand update policy. */
-    bool               _update_requested;
+    bool               _update_requested : 1;
     /* Indicates whether the timestamp shall be encoded in the property or not */
-    bool               _encode_timestamp;
+    bool               _encode_timestamp : 1;
+    /* Indicates whether only the attributes changed since the last update shall be encoded */
+    bool               _encode_changed_attributes_only : 1;
+    /* Indicates whether the unchanged attributes are left out of the message being encoded */
+    bool               _skip_unchanged_attributes : 1;
     /* Indicates if the property shall be echoed back to the cloud even if unchanged */
-    bool               _echo_requested;
-    unsigned long      _timestamp;
+    bool               _echo_requested : 1;
+
+    void markPending();
+    bool skipUnchangedAttributes();
 };
 
 /******************************************************************************
@@ -254,7 +400,7 @@ class Property
  ******************************************************************************/
 
 inline bool operator == (Property const & lhs, Property const & rhs) {
-  return (lhs.name() == rhs.name());
+  return (strcmp(lhs.nameCStr(), rhs.nameCStr()) == 0);
 }
 
 /******************************************************************************
@@ -22,6 +22,7 @@
 #include "PropertyContainer.h"
 
 #include <algorithm>
+#include <limits.h>
 
 #include "types/CloudWrapperBase.h"
 
@@ -31,18 +32,279 @@
 
 void addProperty(PropertyContainer & prop_cont, Property * property_obj, int propertyIdentifier);
 
+/******************************************************************************
+   CONSTANTS
+ ******************************************************************************/
+
+size_t const PropertyContainer::NO_DEADLINE;
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+PropertyContainer::PropertyContainer()
+: _properties()
+, _name_index()
+, _get_time_func{nullptr}
+, _identifier_table()
+, _pending()
+, _polled()
+, _deadlines()
+, _deadline_pos()
+{
+
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void PropertyContainer::push_back(Property * property)
+{
+  _properties.push_back(property);
+  _name_index.add(property);
+
+  if (_pending.size() * 32 < _properties.size())
+  {
+    _pending.push_back(0);
+    _polled.push_back(0);
+  }
+  _deadline_pos.push_back(NO_DEADLINE);
+  property->setContainer(this, _properties.size() - 1);
+
+  int const identifier = property->identifier();
+  if ((identifier >= 0) && (identifier <= MAX_TABLE_IDENTIFIER))
+  {
+    if (static_cast<size_t>(identifier) >= _identifier_table.size())
+      _identifier_table.resize(identifier + 1, nullptr);
+    /* Keep the first property registered with a given identifier */
+    if (_identifier_table[identifier] == nullptr)
+      _identifier_table[identifier] = property;
+  }
+}
+
+Property * PropertyContainer::find(String const & name) const
+{
+  return _name_index.find(name);
+}
+
+Property * PropertyContainer::find(StringView const & prefix, StringView const & name) const
+{
+  return _name_index.find(prefix, name);
+}
+
+Property * PropertyContainer::find(int const identifier) const
+{
+  if ((identifier >= 0) && (identifier <= MAX_TABLE_IDENTIFIER))
+  {
+    if (static_cast<size_t>(identifier) < _identifier_table.size())
+      return _identifier_table[identifier];
+    return nullptr;
+  }
+
+  /* Identifiers which do not fit a light payload are not part of the table */
+  const_iterator iter = std::find_if(_properties.begin(),
+                                     _properties.end(),
+                                     [identifier](Property * p) -> bool
+                                     {
+                                       return (p->identifier() == identifier);
+                                     });
+
+  if (iter == _properties.end())
+    return nullptr;
+  else
+    return (*iter);
+}
+
+void PropertyContainer::markPending(size_t const idx)
+{
+  _pending[idx / 32] |= (1UL << (idx % 32));
+}
+
+void PropertyContainer::clearPending(size_t const idx)
+{
+  _pending[idx / 32] &= ~(1UL << (idx % 32));
+}
+
+void PropertyContainer::setPolled(size_t const idx, bool const polled)
+{
+  if (polled)
+    _polled[idx / 32] |= (1UL << (idx % 32));
+  else
+    _polled[idx / 32] &= ~(1UL << (idx % 32));
+}
+
+size_t PropertyContainer::nextPending(size_t const idx) const
+{
+  return nextSetBit(idx, true, true);
+}
+
+size_t PropertyContainer::nextPolled(size_t const idx) const
+{
+  return nextSetBit(idx, false, true);
+}
+
+size_t PropertyContainer::nextMarked(size_t const idx) const
+{
+  return nextSetBit(idx, true, false);
+}
+
+bool PropertyContainer::hasPending() const
+{
+  for (uint32_t const bits : _pending)
+  {
+    if (bits != 0)
+      return true;
+  }
+  return false;
+}
+
+void PropertyContainer::setDeadline(size_t const idx, unsigned long const deadline_millis)
+{
+  size_t pos = _deadline_pos[idx];
+
+  if (pos == NO_DEADLINE)
+  {
+    pos = _deadlines.size();
+    _deadlines.push_back(Deadline{deadline_millis, idx});
+    _deadline_pos[idx] = pos;
+    siftUp(pos);
+  }
+  else
+  {
+    _deadlines[pos].millis = deadline_millis;
+    siftUp(pos);
+    siftDown(_deadline_pos[idx]);
+  }
+}
+
+void PropertyContainer::clearDeadline(size_t const idx)
+{
+  if (_deadline_pos[idx] != NO_DEADLINE)
+    removeDeadline(_deadline_pos[idx]);
+}
+
+void PropertyContainer::releaseDeadlines(unsigned long const now_millis)
+{
+  while (!_deadlines.empty() && !isBefore(now_millis, _deadlines.front().millis))
+  {
+    markPending(_deadlines.front().idx);
+    removeDeadline(0);
+  }
+}
+
+bool PropertyContainer::nextDeadline(unsigned long & deadline_millis) const
+{
+  if (_deadlines.empty())
+    return false;
+
+  deadline_millis = _deadlines.front().millis;
+  return true;
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+size_t PropertyContainer::nextSetBit(size_t const idx, bool const include_pending, bool const include_polled) const
+{
+  /* Skip 32 idle properties at a time */
+  for (size_t w = idx / 32; w < _polled.size(); w++)
+  {
+    uint32_t bits = include_polled ? _polled[w] : 0;
+    if (include_pending)
+      bits |= _pending[w];
+    if (w == idx / 32)
+      bits &= ~((1UL << (idx % 32)) - 1);
+
+    if (bits != 0)
+    {
+      size_t const next = (w * 32) + __builtin_ctz(bits);
+      return (next < _properties.size()) ? next : _properties.size();
+    }
+  }
+  return _properties.size();
+}
+
+void PropertyContainer::swapDeadlines(size_t const a, size_t const b)
+{
+  std::swap(_deadlines[a], _deadlines[b]);
+  _deadline_pos[_deadlines[a].idx] = a;
+  _deadline_pos[_deadlines[b].idx] = b;
+}
+
+void PropertyContainer::siftUp(size_t pos)
+{
+  while (pos > 0)
+  {
+    size_t const parent = (pos - 1) / 2;
+    if (!isBefore(_deadlines[pos].millis, _deadlines[parent].millis))
+      break;
+    swapDeadlines(pos, parent);
+    pos = parent;
+  }
+}
+
+void PropertyContainer::siftDown(size_t pos)
+{
+  for (;;)
+  {
+    size_t const left = (2 * pos) + 1;
+    size_t const right = left + 1;
+    size_t earliest = pos;
+
+    if (left < _deadlines.size() && isBefore(_deadlines[left].millis, _deadlines[earliest].millis))
+      earliest = left;
+    if (right < _deadlines.size() && isBefore(_deadlines[right].millis, _deadlines[earliest].millis))
+      earliest = right;
+    if (earliest == pos)
+      break;
+
+    swapDeadlines(pos, earliest);
+    pos = earliest;
+  }
+}
+
+void PropertyContainer::removeDeadline(size_t const pos)
+{
+  size_t const last = _deadlines.size() - 1;
+
+  _deadline_pos[_deadlines[pos].idx] = NO_DEADLINE;
+  if (pos != last)
+  {
+    _deadlines[pos] = _deadlines[last];
+    _deadline_pos[_deadlines[pos].idx] = pos;
+  }
+  _deadlines.pop_back();
+
+  if (pos < _deadlines.size())
+  {
+    siftUp(pos);
+    siftDown(_deadline_pos[_deadlines[pos].idx]);
+  }
+}
+
+bool PropertyContainer::isBefore(unsigned long const lhs, unsigned long const rhs)
+{
+  /* Robust against the millis() overflow as long as deadlines are less than ~24 days apart */
+  return static_cast<long>(lhs - rhs) < 0;
+}
+
 /******************************************************************************
    PUBLIC FUNCTION DEFINITION
  ******************************************************************************/
 
 Property & addPropertyToContainer(PropertyContainer & prop_cont, Property & property, String const & name, Permission const permission, int propertyIdentifier, GetTimeCallbackFunc func)
 {
+  /* The time source is kept once by the container, the last one passed applies to all its properties */
+  prop_cont.setTimeFunc(func);
+
   /* Check whether or not the property already has been added to the container */
   Property * p = getProperty(prop_cont, name);
   if(p != nullptr) return (*p);
 
   /* Initialize property and add it to the container */
-  property.init(name, permission, func);
+  property.init(name, permission);
 
   addProperty(prop_cont, &property, propertyIdentifier);
   return property;
@@ -51,36 +313,17 @@ Property & addPropertyToContainer(PropertyContainer & prop_cont, Property & prop
 
 Property * getProperty(PropertyContainer & prop_cont, String const & name)
 {
-  std::list<Property *>::iterator iter;
-
-  iter = std::find_if(prop_cont.begin(),
-                      prop_cont.end(),
-                      [name](Property * p) -> bool
-                      {
-                        return (p->name() == name);
-                      });
+  return prop_cont.find(name);
+}
 
-  if (iter == prop_cont.end())
-    return nullptr;
-  else
-    return (*iter);
+Property * getProperty(PropertyContainer & prop_cont, StringView const & prefix, StringView const & name)
+{
+  return prop_cont.find(prefix, name);
 }
 
 Property * getProperty(PropertyContainer & prop_cont, int const identifier)
 {
-  std::list<Property *>::iterator iter;
-
-  iter = std::find_if(prop_cont.begin(),
-                      prop_cont.end(),
-                      [identifier](Property * p) -> bool
-                      {
-                        return (p->identifier() == identifier);
-                      });
-
-  if (iter == prop_cont.end())
-    return nullptr;
-  else
-    return (*iter);
+  return prop_cont.find(identifier);
 }
 
 void requestUpdateForAllProperties(PropertyContainer & prop_cont)
@@ -98,26 +341,28 @@ void updateTimestampOnLocallyChangedProperties(PropertyContainer & prop_cont)
   /* This function updates the timestamps on the primitive properties
    * that have been modified locally since last cloud synchronization
    */
-  std::for_each(prop_cont.begin(),
-                prop_cont.end(),
-                [](Property * p)
-                {
-                  CloudWrapperBase * pbase = reinterpret_cast<CloudWrapperBase *>(p);
-                  if (pbase->isPrimitive() && pbase->isChangedLocally() && pbase->isReadableByCloud())
-                  {
-                    p->updateLocalTimestamp();
-                  }
-                });
+  for (size_t idx = prop_cont.nextPolled(0); idx < prop_cont.size(); idx = prop_cont.nextPolled(idx + 1))
+  {
+    Property * p = prop_cont[idx];
+    CloudWrapperBase * pbase = reinterpret_cast<CloudWrapperBase *>(p);
+    if (pbase->isPrimitive() && pbase->isChangedLocally() && pbase->isReadableByCloud())
+    {
+      p->updateLocalTimestamp();
+    }
+  }
 }
 
-void updateProperty(PropertyContainer & prop_cont, String propertyName, unsigned long cloudChangeEventTime, bool const is_sync_message, std::list<CborMapData> * map_data_list)
+void updateProperty(PropertyContainer & prop_cont, String const & propertyName, unsigned long cloudChangeEventTime, bool const is_sync_message, CborMapDataArena * map_data_arena)
 {
-  Property * property = getProperty(prop_cont, propertyName);
+  updateProperty(prop_cont, getProperty(prop_cont, propertyName), cloudChangeEventTime, is_sync_message, map_data_arena);
+}
 
+void updateProperty(PropertyContainer & /* prop_cont */, Property * property, unsigned long cloudChangeEventTime, bool const is_sync_message, CborMapDataArena * map_data_arena)
+{
   if (property && property->isWriteableByCloud())
   {
     property->setLastCloudChangeTimestamp(cloudChangeEventTime);
-    property->setAttributesFromCloud(map_data_list);
+    property->setAttributesFromCloud(map_data_arena);
     if (is_sync_message) {
       property->execCallbackOnSync();
     } else {
@@ -140,11 +385,28 @@ String getPropertyNameByIdentifier(PropertyContainer & prop_cont, int propertyId
     property = getProperty(prop_cont, propertyIdentifier);
 
   if (property)
-    return property->name();
+    return property->nameCStr();
   else
     return String("");
 }
 
+unsigned long nextDeadlineMillis(PropertyContainer & prop_cont, unsigned long const now_millis)
+{
+  /* Properties already pending are sent on the next update */
+  if (prop_cont.hasPending())
+    return now_millis;
+
+  /* Nothing scheduled, report the farthest point in time millis() can express */
+  unsigned long deadline_millis = 0;
+  if (!prop_cont.nextDeadline(deadline_millis))
+    return now_millis + LONG_MAX;
+
+  if (static_cast<long>(deadline_millis - now_millis) < 0)
+    return now_millis;
+  else
+    return deadline_millis;
+}
+
 /******************************************************************************
    INTERNAL FUNCTION DEFINITION
  ******************************************************************************/
@@ -25,10 +25,12 @@
 #include <Arduino.h>
 
 #include "Property.h"
+#include "PropertyNameIndex.h"
 
 #undef max
 #undef min
 #include <list>
+#include <vector>
 
 #include "types/CloudBool.h"
 #include "types/CloudFloat.h"
@@ -57,10 +59,101 @@
 extern "C" unsigned long getTime();
 
 /******************************************************************************
-   TYPEDEF
+   CLASS DECLARATION
  ******************************************************************************/
 
-typedef std::list<Property *> PropertyContainer;
+/* Properties are stored contiguously so that the periodic scans done by the
+ * encoder walk a single array and can resume at any index in constant time.
+ * Properties notify the container when they may need to be sent to the cloud,
+ * the encoder then only visits those pending properties and the polled ones.
+ * Properties which become due after some time register a deadline instead,
+ * kept in a min-heap, and are flagged as pending once it expires.
+ */
+class PropertyContainer
+{
+public:
+
+  PropertyContainer();
+  PropertyContainer(PropertyContainer const &) = delete;
+  PropertyContainer & operator = (PropertyContainer const &) = delete;
+
+  typedef std::vector<Property *>::iterator       iterator;
+  typedef std::vector<Property *>::const_iterator const_iterator;
+
+  inline iterator       begin()       { return _properties.begin(); }
+  inline iterator       end  ()       { return _properties.end(); }
+  inline const_iterator begin() const { return _properties.begin(); }
+  inline const_iterator end  () const { return _properties.end(); }
+  inline size_t         size () const { return _properties.size(); }
+  inline bool           empty() const { return _properties.empty(); }
+  inline Property *     operator[](size_t const idx) const { return _properties[idx]; }
+
+  void       push_back(Property * property);
+
+  /* Source of the timestamps of the local changes, shared by all the properties of the container */
+  inline void          setTimeFunc(GetTimeCallbackFunc func) { _get_time_func = func; }
+  inline unsigned long currentTime() const { return (_get_time_func != nullptr) ? _get_time_func() : 0; }
+  Property * find     (String const & name) const;
+  Property * find     (StringView const & prefix, StringView const & name) const;
+  Property * find     (int const identifier) const;
+
+  void   markPending (size_t const idx);
+  void   clearPending(size_t const idx);
+  void   setPolled   (size_t const idx, bool const polled);
+  /* Return the index of the first pending or polled property at or after idx, size() if none */
+  size_t nextPending (size_t const idx) const;
+  /* Return the index of the first polled property at or after idx, size() if none */
+  size_t nextPolled  (size_t const idx) const;
+  /* Return the index of the first property marked pending at or after idx, the polled ones aside, size() if none */
+  size_t nextMarked  (size_t const idx) const;
+
+  bool   hasPending() const;
+
+  void   setDeadline     (size_t const idx, unsigned long const deadline_millis);
+  void   clearDeadline   (size_t const idx);
+  /* Flag as pending every property whose deadline is not later than now_millis */
+  void   releaseDeadlines(unsigned long const now_millis);
+  /* Return false if no deadline is registered */
+  bool   nextDeadline    (unsigned long & deadline_millis) const;
+
+private:
+
+  /* Light payloads pack the property identifier into the 8 least significant bits */
+  static int const MAX_TABLE_IDENTIFIER = 255;
+
+  std::vector<Property *> _properties;
+  PropertyNameIndex _name_index;
+  GetTimeCallbackFunc _get_time_func;
+  /* Dense identifier -> Property table, indexed by Property::identifier() */
+  std::vector<Property *> _identifier_table;
+  /* One bit per property, indexed by the position of the property in the container */
+  std::vector<uint32_t> _pending;
+  std::vector<uint32_t> _polled;
+
+  struct Deadline
+  {
+    unsigned long millis;
+    size_t        idx;
+  };
+
+  static size_t const NO_DEADLINE = SIZE_MAX;
+
+  /* Min-heap of deadlines, at most one per property */
+  std::vector<Deadline> _deadlines;
+  /* Position of each property deadline within the heap, NO_DEADLINE if none */
+  std::vector<size_t> _deadline_pos;
+
+  size_t nextSetBit(size_t const idx, bool const include_pending, bool const include_polled) const;
+  void   swapDeadlines(size_t const a, size_t const b);
+  void   siftUp       (size_t pos);
+  void   siftDown     (size_t pos);
+  void   removeDeadline(size_t const pos);
+  static bool isBefore(unsigned long const lhs, unsigned long const rhs);
+};
+
+/******************************************************************************
+   TYPEDEF
+ ******************************************************************************/
 
 typedef CloudFloat CloudEnergy;
 typedef CloudFloat CloudForce;
@@ -106,12 +199,15 @@ Property & addPropertyToContainer(PropertyContainer & prop_cont,
 
   
 Property * getProperty(PropertyContainer & prop_cont, String const & name);
+Property * getProperty(PropertyContainer & prop_cont, StringView const & prefix, StringView const & name);
 Property * getProperty(PropertyContainer & prop_cont, int const identifier);
 
 
 void updateTimestampOnLocallyChangedProperties(PropertyContainer & prop_cont);
 void requestUpdateForAllProperties(PropertyContainer & prop_cont);
-void updateProperty(PropertyContainer & prop_cont, String propertyName, unsigned long cloudChangeEventTime, bool const is_sync_message, std::list<CborMapData> * map_data_list);
+void updateProperty(PropertyContainer & prop_cont, String const & propertyName, unsigned long cloudChangeEventTime, bool const is_sync_message, CborMapDataArena * map_data_arena);
+void updateProperty(PropertyContainer & prop_cont, Property * property, unsigned long cloudChangeEventTime, bool const is_sync_message, CborMapDataArena * map_data_arena);
 String getPropertyNameByIdentifier(PropertyContainer & prop_cont, int propertyIdentifier);
+unsigned long nextDeadlineMillis(PropertyContainer & prop_cont, unsigned long const now_millis);
 
 #endif /* ARDUINO_PROPERTY_CONTAINER_H_ */
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "PropertyNameIndex.h"
+
+#include "Property.h"
+
+/******************************************************************************
+   CONSTANTS
+ ******************************************************************************/
+
+static uint32_t const FNV1A_OFFSET_BASIS = 2166136261UL;
+static uint32_t const FNV1A_PRIME        = 16777619UL;
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+PropertyNameIndex::PropertyNameIndex()
+: _table()
+, _count{0}
+{
+
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void PropertyNameIndex::add(Property * property)
+{
+  /* Keep the load factor below 3/4 so that probe sequences stay short */
+  if (((_count + 1) * 4) > (_table.size() * 3))
+    grow();
+
+  Entry const entry = {hash(property->nameCStr()), property};
+  insert(entry);
+  _count++;
+}
+
+Property * PropertyNameIndex::find(String const & name) const
+{
+  return find(StringView(), StringView(name.c_str(), name.length()));
+}
+
+Property * PropertyNameIndex::find(StringView const & prefix, StringView const & name) const
+{
+  if (_count == 0)
+    return nullptr;
+
+  /* FNV-1a is computed byte by byte, hashing both parts in turn equals hashing the whole name */
+  uint32_t const name_hash = hash(hash(FNV1A_OFFSET_BASIS, prefix), name);
+  size_t const mask = _table.size() - 1;
+
+  for (size_t i = name_hash & mask; _table[i].property != nullptr; i = (i + 1) & mask)
+  {
+    if (_table[i].hash != name_hash)
+      continue;
+
+    StringView const property_name(_table[i].property->nameCStr());
+    if ((property_name.length() == (prefix.length() + name.length())) &&
+        (StringView(property_name.data(), prefix.length()) == prefix) &&
+        (StringView(property_name.data() + prefix.length(), name.length()) == name))
+      return _table[i].property;
+  }
+
+  return nullptr;
+}
+
+uint32_t PropertyNameIndex::hash(char const * str)
+{
+  return hash(FNV1A_OFFSET_BASIS, StringView(str));
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void PropertyNameIndex::grow()
+{
+  size_t const new_capacity = _table.empty() ? MIN_CAPACITY : (_table.size() * 2);
+
+  std::vector<Entry> old_table;
+  old_table.swap(_table);
+  _table.resize(new_capacity, Entry{0, nullptr});
+
+  for (Entry const & entry : old_table) {
+    if (entry.property != nullptr)
+      insert(entry);
+  }
+}
+
+void PropertyNameIndex::insert(Entry const & entry)
+{
+  size_t const mask = _table.size() - 1;
+  size_t i = entry.hash & mask;
+  while (_table[i].property != nullptr)
+    i = (i + 1) & mask;
+  _table[i] = entry;
+}
+
+uint32_t PropertyNameIndex::hash(uint32_t h, StringView const & str)
+{
+  for (size_t i = 0; i < str.length(); i++) {
+    h ^= static_cast<uint8_t>(str.data()[i]);
+    h *= FNV1A_PRIME;
+  }
+  return h;
+}
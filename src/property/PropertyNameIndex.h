@@ -0,0 +1,73 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_PROPERTY_NAME_INDEX_H_
+#define ARDUINO_PROPERTY_NAME_INDEX_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#undef max
+#undef min
+#include <vector>
+
+#include "StringView.h"
+
+/******************************************************************************
+   FORWARD DECLARATION
+ ******************************************************************************/
+
+class Property;
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Open addressing hash table mapping a property name to its Property object.
+ * The FNV-1a hash of each name is computed once when the property is added,
+ * afterwards a lookup only hashes the requested name and compares the stored
+ * names of the colliding entries, without any heap allocation.
+ */
+class PropertyNameIndex
+{
+public:
+
+  PropertyNameIndex();
+
+  void       add (Property * property);
+  Property * find(String const & name) const;
+  /* Look up the property named prefix followed by name */
+  Property * find(StringView const & prefix, StringView const & name) const;
+
+  static uint32_t hash(char const * str);
+
+private:
+
+  struct Entry
+  {
+    uint32_t   hash;
+    Property * property;
+  };
+
+  static size_t const MIN_CAPACITY = 16;
+
+  std::vector<Entry> _table;
+  size_t _count;
+
+  void grow();
+  void insert(Entry const & entry);
+
+  static uint32_t hash(uint32_t h, StringView const & str);
+};
+
+#endif /* ARDUINO_PROPERTY_NAME_INDEX_H_ */
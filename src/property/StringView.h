@@ -0,0 +1,73 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_PROPERTY_STRING_VIEW_H_
+#define ARDUINO_PROPERTY_STRING_VIEW_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#include <string.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Length bounded, not null terminated view of characters owned by someone else,
+ * e.g. a text string inside the CBOR payload being decoded. A view must not be
+ * used after the characters it refers to are gone.
+ */
+class StringView
+{
+public:
+
+  StringView() : _str(""), _length(0) { }
+  StringView(char const * str) : _str(str), _length(strlen(str)) { }
+  StringView(char const * str, size_t const length) : _str(str), _length(length) { }
+
+  inline char const * data  () const { return _str; }
+  inline size_t       length() const { return _length; }
+  inline bool         empty () const { return _length == 0; }
+
+  inline bool operator == (StringView const & other) const {
+    return (_length == other._length) && (memcmp(_str, other._str, _length) == 0);
+  }
+  inline bool operator == (char const * str) const {
+    return *this == StringView(str);
+  }
+
+  /* Split at the first occurrence of separator, return false if there is none */
+  inline bool split(char const separator, StringView & head, StringView & tail) const {
+    char const * pos = static_cast<char const *>(memchr(_str, separator, _length));
+    if (pos == nullptr)
+      return false;
+    head = StringView(_str, pos - _str);
+    tail = StringView(pos + 1, _length - (pos - _str) - 1);
+    return true;
+  }
+
+  /* Replace the content of str with the viewed characters */
+  inline void copyTo(String & str) const {
+    str = "";
+    str.reserve(_length);
+    for (size_t i = 0; i < _length; i++)
+      str += _str[i];
+  }
+
+private:
+
+  char const * _str;
+  size_t _length;
+};
+
+#endif /* ARDUINO_PROPERTY_STRING_VIEW_H_ */
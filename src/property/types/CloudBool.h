@@ -43,6 +43,9 @@ class CloudBool : public Property {
     operator bool() const                             {
       return _value;
     }
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value;
     }
@@ -55,6 +58,9 @@ class CloudBool : public Property {
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
       return appendAttribute(_value, "", encoder);
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value, "", lightPayload);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
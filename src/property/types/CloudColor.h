@@ -161,6 +161,9 @@ class CloudColor : public Property {
     CloudColor() : _value(0, 0, 0), _cloud_value(0, 0, 0) {}
     CloudColor(float hue, float saturation, float brightness) : _value(hue, saturation, brightness), _cloud_value(hue, saturation, brightness) {}
 
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
 
       return _value != _cloud_value;
@@ -189,11 +192,16 @@ class CloudColor : public Property {
       _cloud_value = _value;
     }
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
-      CHECK_CBOR_MULTI(appendAttribute(_value.hue, "hue", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.sat, "sat", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.bri, "bri", encoder));
+      CHECK_CBOR_MULTI(appendAttribute(_value.hue, "hue", encoder, _value.hue != _cloud_value.hue));
+      CHECK_CBOR_MULTI(appendAttribute(_value.sat, "sat", encoder, _value.sat != _cloud_value.sat));
+      CHECK_CBOR_MULTI(appendAttribute(_value.bri, "bri", encoder, _value.bri != _cloud_value.bri));
       return CborNoError;
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value.hue, "hue", lightPayload, _value.hue != _cloud_value.hue) +
+             attributeSizeHint(_value.sat, "sat", lightPayload, _value.sat != _cloud_value.sat) +
+             attributeSizeHint(_value.bri, "bri", lightPayload, _value.bri != _cloud_value.bri);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value.hue, "hue");
       setAttribute(_cloud_value.sat, "sat");
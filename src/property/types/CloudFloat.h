@@ -46,6 +46,9 @@ class CloudFloat : public Property {
     operator float() const {
       return _value;
     }
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return arduino::math::ieee754_different(_value, _cloud_value, Property::_min_delta_property);
     }
@@ -58,6 +61,9 @@ class CloudFloat : public Property {
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
       return appendAttribute(_value, "", encoder);
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value, "", lightPayload);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
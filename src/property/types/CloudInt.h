@@ -43,6 +43,9 @@ class CloudInt : public Property {
     operator int() const {
       return _value;
     }
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value && (abs(_value - _cloud_value) >= Property::_min_delta_property);
     }
@@ -55,6 +58,9 @@ class CloudInt : public Property {
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
       return appendAttribute(_value, "", encoder);
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value, "", lightPayload);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
@@ -63,6 +63,9 @@ class CloudLocation : public Property {
   public:
     CloudLocation() : _value(0, 0), _cloud_value(0, 0) {}
     CloudLocation(float lat, float lon) : _value(lat, lon), _cloud_value(lat, lon) {}
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       float const distance = Location::distance(_value, _cloud_value);
       return _value != _cloud_value && (abs(distance) >= Property::_min_delta_property);
@@ -90,10 +93,14 @@ class CloudLocation : public Property {
       _cloud_value = _value;
     }
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
-      CHECK_CBOR_MULTI(appendAttribute(_value.lat, "lat", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.lon, "lon", encoder));
+      CHECK_CBOR_MULTI(appendAttribute(_value.lat, "lat", encoder, _value.lat != _cloud_value.lat));
+      CHECK_CBOR_MULTI(appendAttribute(_value.lon, "lon", encoder, _value.lon != _cloud_value.lon));
       return CborNoError;
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value.lat, "lat", lightPayload, _value.lat != _cloud_value.lat) +
+             attributeSizeHint(_value.lon, "lon", lightPayload, _value.lon != _cloud_value.lon);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value.lat, "lat");
       setAttribute(_cloud_value.lon, "lon");
@@ -384,6 +384,9 @@ class CloudSchedule : public Property {
     CloudSchedule() : _value(0, 0, 0, 0), _cloud_value(0, 0, 0, 0) {}
     CloudSchedule(unsigned int frm, unsigned int to, unsigned int len, unsigned int msk) : _value(frm, to, len, msk), _cloud_value(frm, to, len, msk) {}
 
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
 
       return _value != _cloud_value;
@@ -423,6 +426,12 @@ class CloudSchedule : public Property {
       CHECK_CBOR_MULTI(appendAttribute(_value.msk, "msk", encoder));
       return CborNoError;
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value.frm, "frm", lightPayload) +
+             attributeSizeHint(_value.to, "to", lightPayload) +
+             attributeSizeHint(_value.len, "len", lightPayload) +
+             attributeSizeHint(_value.msk, "msk", lightPayload);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value.frm, "frm");
       setAttribute(_cloud_value.to, "to");
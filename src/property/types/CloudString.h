@@ -48,6 +48,10 @@ class CloudString : public Property {
     }
     void clear() {
       _value = PropertyActions::CLEAR;
+      updateLocalTimestamp();
+    }
+    virtual bool notifiesLocalChanges() const {
+      return true;
     }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value;
@@ -61,6 +65,9 @@ class CloudString : public Property {
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
       return appendAttribute(_value, "", encoder);
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value, "", lightPayload);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
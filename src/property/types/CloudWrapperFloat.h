@@ -51,6 +51,9 @@ class CloudWrapperFloat : public CloudWrapperBase {
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
       return appendAttribute(_primitive_value, "", encoder);
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_primitive_value, "", lightPayload);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
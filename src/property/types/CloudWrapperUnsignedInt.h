@@ -48,6 +48,9 @@ class CloudWrapperUnsignedInt : public CloudWrapperBase {
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
       return appendAttribute(_primitive_value, "", encoder);
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_primitive_value, "", lightPayload);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
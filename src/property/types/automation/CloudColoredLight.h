@@ -119,12 +119,18 @@ class CloudColoredLight : public CloudColor {
       _cloud_value = _value;
     }
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
-      CHECK_CBOR_MULTI(appendAttribute(_value.swi, "swi", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.hue, "hue", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.sat, "sat", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.bri, "bri", encoder));
+      CHECK_CBOR_MULTI(appendAttribute(_value.swi, "swi", encoder, _value.swi != _cloud_value.swi));
+      CHECK_CBOR_MULTI(appendAttribute(_value.hue, "hue", encoder, _value.hue != _cloud_value.hue));
+      CHECK_CBOR_MULTI(appendAttribute(_value.sat, "sat", encoder, _value.sat != _cloud_value.sat));
+      CHECK_CBOR_MULTI(appendAttribute(_value.bri, "bri", encoder, _value.bri != _cloud_value.bri));
       return CborNoError;
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value.swi, "swi", lightPayload, _value.swi != _cloud_value.swi) +
+             attributeSizeHint(_value.hue, "hue", lightPayload, _value.hue != _cloud_value.hue) +
+             attributeSizeHint(_value.sat, "sat", lightPayload, _value.sat != _cloud_value.sat) +
+             attributeSizeHint(_value.bri, "bri", lightPayload, _value.bri != _cloud_value.bri);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value.swi, "swi");
       setAttribute(_cloud_value.hue, "hue");
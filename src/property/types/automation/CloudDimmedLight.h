@@ -55,6 +55,9 @@ class CloudDimmedLight : public Property {
     CloudDimmedLight() : _value(false, 0), _cloud_value(false, 0) {}
     CloudDimmedLight(bool swi, float brightness) : _value(swi, brightness), _cloud_value(swi, brightness) {}
 
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
 
       return _value != _cloud_value;
@@ -81,6 +84,7 @@ class CloudDimmedLight : public Property {
 
     void setBrightness(float const bri) {
       _value.bri = bri;
+      updateLocalTimestamp();
     }
 
     bool getSwitch() {
@@ -89,6 +93,7 @@ class CloudDimmedLight : public Property {
 
     void setSwitch(bool const swi) {
       _value.swi = swi;
+      updateLocalTimestamp();
     }
 
     virtual void fromCloudToLocal() {
@@ -99,10 +104,14 @@ class CloudDimmedLight : public Property {
     }
 
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
-      CHECK_CBOR_MULTI(appendAttribute(_value.swi, "swi", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.bri, "bri", encoder));
+      CHECK_CBOR_MULTI(appendAttribute(_value.swi, "swi", encoder, _value.swi != _cloud_value.swi));
+      CHECK_CBOR_MULTI(appendAttribute(_value.bri, "bri", encoder, _value.bri != _cloud_value.bri));
       return CborNoError;
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value.swi, "swi", lightPayload, _value.swi != _cloud_value.swi) +
+             attributeSizeHint(_value.bri, "bri", lightPayload, _value.bri != _cloud_value.bri);
+    }
 
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value.swi, "swi");
@@ -144,6 +144,9 @@ class CloudTelevision : public Property {
     CloudTelevision() : _value(false, 0, false, PlaybackCommands::None, InputValue::TV, 0), _cloud_value(false, 0, false, PlaybackCommands::None, InputValue::TV, 0) {}
     CloudTelevision(bool const swi, int const vol, bool const mut, PlaybackCommands const pbc, InputValue const inp, int const cha) : _value(swi, vol, mut, pbc, inp, cha), _cloud_value(swi, vol, mut, pbc, inp, cha) {}
 
+    virtual bool notifiesLocalChanges() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
 
       return _value != _cloud_value;
@@ -214,14 +217,22 @@ class CloudTelevision : public Property {
       _cloud_value = _value;
     }
     virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
-      CHECK_CBOR_MULTI(appendAttribute(_value.swi, "swi", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.vol, "vol", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.mut, "mut", encoder));
-      CHECK_CBOR_MULTI(appendAttribute((int)_value.pbc, "pbc", encoder));
-      CHECK_CBOR_MULTI(appendAttribute((int)_value.inp, "inp", encoder));
-      CHECK_CBOR_MULTI(appendAttribute(_value.cha, "cha", encoder));
+      CHECK_CBOR_MULTI(appendAttribute(_value.swi, "swi", encoder, _value.swi != _cloud_value.swi));
+      CHECK_CBOR_MULTI(appendAttribute(_value.vol, "vol", encoder, _value.vol != _cloud_value.vol));
+      CHECK_CBOR_MULTI(appendAttribute(_value.mut, "mut", encoder, _value.mut != _cloud_value.mut));
+      CHECK_CBOR_MULTI(appendAttribute((int)_value.pbc, "pbc", encoder, _value.pbc != _cloud_value.pbc));
+      CHECK_CBOR_MULTI(appendAttribute((int)_value.inp, "inp", encoder, _value.inp != _cloud_value.inp));
+      CHECK_CBOR_MULTI(appendAttribute(_value.cha, "cha", encoder, _value.cha != _cloud_value.cha));
       return CborNoError;
     }
+    virtual size_t encodedSizeHint(bool const lightPayload) const {
+      return attributeSizeHint(_value.swi, "swi", lightPayload, _value.swi != _cloud_value.swi) +
+             attributeSizeHint(_value.vol, "vol", lightPayload, _value.vol != _cloud_value.vol) +
+             attributeSizeHint(_value.mut, "mut", lightPayload, _value.mut != _cloud_value.mut) +
+             attributeSizeHint((int)_value.pbc, "pbc", lightPayload, _value.pbc != _cloud_value.pbc) +
+             attributeSizeHint((int)_value.inp, "inp", lightPayload, _value.inp != _cloud_value.inp) +
+             attributeSizeHint(_value.cha, "cha", lightPayload, _value.cha != _cloud_value.cha);
+    }
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value.swi, "swi");
       setAttribute(_cloud_value.vol, "vol");
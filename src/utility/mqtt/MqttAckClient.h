@@ -0,0 +1,100 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_ACK_CLIENT_H_
+#define ARDUINO_IOT_CLOUD_MQTT_ACK_CLIENT_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <Client.h>
+
+#include "MqttPacketIdParser.h"
+#include "MqttOutboundQueue.h"
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Passes everything through to the broker client and follows the packet identifiers
+ * of the QoS 1 messages, which the MQTT client keeps to itself. The identifier of each
+ * PUBLISH written is recorded, each PUBACK read releases the queued message carrying
+ * the same identifier.
+ */
+class MqttAckClient : public Client
+{
+public:
+
+  MqttAckClient(Client & client, MqttOutboundQueue & queue)
+  : _client(client)
+  , _published_id{0}
+  , _outbound(MqttPacketIdParser::PacketType::Publish, [this](uint16_t const packet_id) { _published_id = packet_id; })
+  , _inbound(MqttPacketIdParser::PacketType::PubAck, [&queue](uint16_t const packet_id) { queue.acknowledge(packet_id); })
+  { }
+
+  /* Packet identifier of the last QoS 1 or 2 message written */
+  inline uint16_t publishedPacketId() const { return _published_id; }
+
+  virtual int connect(IPAddress ip, uint16_t port) override { reset(); return _client.connect(ip, port); }
+  virtual int connect(const char * host, uint16_t port) override { reset(); return _client.connect(host, port); }
+
+  virtual size_t write(uint8_t b) override {
+    size_t const n = _client.write(b);
+    if (n > 0) {
+      _outbound.feed(&b, 1);
+    }
+    return n;
+  }
+
+  virtual size_t write(const uint8_t * buf, size_t size) override {
+    size_t const n = _client.write(buf, size);
+    _outbound.feed(buf, n);
+    return n;
+  }
+
+  virtual int available() override { return _client.available(); }
+  virtual int peek() override { return _client.peek(); }
+  virtual void flush() override { _client.flush(); }
+  virtual void stop() override { _client.stop(); }
+  virtual uint8_t connected() override { return _client.connected(); }
+  virtual operator bool() override { return static_cast<bool>(_client); }
+
+  virtual int read() override {
+    int const b = _client.read();
+    if (b >= 0) {
+      uint8_t const byte = static_cast<uint8_t>(b);
+      _inbound.feed(&byte, 1);
+    }
+    return b;
+  }
+
+  virtual int read(uint8_t * buf, size_t size) override {
+    int const n = _client.read(buf, size);
+    if (n > 0) {
+      _inbound.feed(buf, static_cast<size_t>(n));
+    }
+    return n;
+  }
+
+private:
+
+  Client & _client;
+  uint16_t _published_id;
+  MqttPacketIdParser _outbound;
+  MqttPacketIdParser _inbound;
+
+  inline void reset() {
+    _outbound.reset();
+    _inbound.reset();
+  }
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_ACK_CLIENT_H_ */
@@ -0,0 +1,124 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "MqttOutboundQueue.h"
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+MqttOutboundQueue::MqttOutboundQueue()
+: _buf{nullptr}
+, _entries{nullptr}
+, _depth{0}
+, _slot_size{0}
+, _head{0}
+, _count{0}
+, _in_flight{0}
+{
+
+}
+
+MqttOutboundQueue::~MqttOutboundQueue()
+{
+  delete[] _buf;
+  delete[] _entries;
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void MqttOutboundQueue::begin(size_t const depth, size_t const slot_size)
+{
+  if (_buf != nullptr || depth == 0)
+    return;
+
+  /* The length of the messages is kept in 16 bits, larger slots could not be used */
+  _slot_size = (slot_size < UINT16_MAX) ? slot_size : UINT16_MAX;
+  _buf = new uint8_t[depth * _slot_size];
+  _entries = new Entry[depth];
+  _depth = depth;
+}
+
+uint8_t * MqttOutboundQueue::reserve()
+{
+  if (_buf == nullptr || full())
+    return nullptr;
+
+  return _buf + index(_count) * _slot_size;
+}
+
+void MqttOutboundQueue::commit(size_t const length)
+{
+  if (_buf == nullptr || full() || length == 0 || length > _slot_size)
+    return;
+
+  Entry & entry = _entries[index(_count)];
+  entry.length = static_cast<uint16_t>(length);
+  entry.packet_id = 0;
+  entry.dup = false;
+  _count++;
+}
+
+bool MqttOutboundQueue::nextUnsent(uint8_t const * & data, size_t & length, bool & dup) const
+{
+  if (!hasUnsent())
+    return false;
+
+  size_t const idx = index(_in_flight);
+  data = _buf + idx * _slot_size;
+  length = _entries[idx].length;
+  dup = _entries[idx].dup;
+  return true;
+}
+
+void MqttOutboundQueue::markSent(uint16_t const packet_id)
+{
+  if (!hasUnsent())
+    return;
+
+  _entries[index(_in_flight)].packet_id = packet_id;
+  _in_flight++;
+}
+
+bool MqttOutboundQueue::acknowledge(uint16_t const packet_id)
+{
+  for (size_t i = 0; i < _in_flight; i++)
+  {
+    if (_entries[index(i)].packet_id == packet_id)
+    {
+      _head = index(i + 1);
+      _count -= i + 1;
+      _in_flight -= i + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+void MqttOutboundQueue::requeueInFlight()
+{
+  for (size_t i = 0; i < _in_flight; i++) {
+    _entries[index(i)].dup = true;
+  }
+  _in_flight = 0;
+}
+
+void MqttOutboundQueue::clear()
+{
+  _head = 0;
+  _count = 0;
+  _in_flight = 0;
+}
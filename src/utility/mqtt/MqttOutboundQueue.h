@@ -0,0 +1,95 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_OUTBOUND_QUEUE_H_
+#define ARDUINO_IOT_CLOUD_MQTT_OUTBOUND_QUEUE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Bounded ring of outbound messages published with QoS 1. Messages are encoded
+ * straight into a slot of the queue and stay there until they are acknowledged,
+ * several of them can be in flight at the same time. If the connection is lost
+ * the messages in flight are published again, flagged as duplicates.
+ *
+ * Messages are published in order, therefore the messages in flight are always
+ * the oldest ones of the queue and the ones still to be published follow them.
+ * Each message in flight is matched to its PUBACK by the MQTT packet identifier.
+ */
+class MqttOutboundQueue
+{
+public:
+
+  MqttOutboundQueue();
+  ~MqttOutboundQueue();
+
+  MqttOutboundQueue(MqttOutboundQueue const &) = delete;
+  MqttOutboundQueue & operator = (MqttOutboundQueue const &) = delete;
+
+  /* Allocate depth slots of slot_size bytes each, at most UINT16_MAX bytes, the sizes can not be changed afterwards */
+  void begin(size_t const depth, size_t const slot_size);
+
+  inline size_t depth   () const { return _depth; }
+  inline size_t slotSize() const { return _slot_size; }
+  inline size_t size    () const { return _count; }
+  inline size_t inFlight() const { return _in_flight; }
+  inline bool   empty   () const { return _count == 0; }
+  inline bool   full    () const { return _count == _depth; }
+  inline bool   hasUnsent() const { return _in_flight < _count; }
+
+  /* Slot the next message is encoded into, nullptr if the queue is full */
+  uint8_t * reserve();
+  /* Append the message of length bytes encoded into the slot returned by reserve() */
+  void      commit(size_t const length);
+
+  /* Oldest message not published yet, return false if there is none */
+  bool      nextUnsent(uint8_t const * & data, size_t & length, bool & dup) const;
+  /* The message returned by nextUnsent() has been published with packet_id */
+  void      markSent(uint16_t const packet_id);
+
+  /* Release the message in flight published with packet_id, together with the older ones
+   * since the broker acknowledges in order. Return false if no message matches, e.g. the
+   * PUBACK of a message that has not been published through the queue.
+   */
+  bool      acknowledge(uint16_t const packet_id);
+
+  /* The connection has been lost, publish every message in flight again */
+  void      requeueInFlight();
+  void      clear();
+
+private:
+
+  struct Entry
+  {
+    uint16_t length;
+    uint16_t packet_id;
+    bool     dup;
+  };
+
+  uint8_t * _buf;
+  Entry * _entries;
+  size_t _depth;
+  size_t _slot_size;
+  size_t _head;
+  size_t _count;
+  size_t _in_flight;
+
+  inline size_t index(size_t const offset) const { return (_head + offset) % _depth; }
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_OUTBOUND_QUEUE_H_ */
@@ -0,0 +1,129 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "MqttPacketIdParser.h"
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+MqttPacketIdParser::MqttPacketIdParser(PacketType const type, OnPacketId on_packet_id)
+: _packet_type{type}
+, _on_packet_id{on_packet_id}
+, _state{State::Type}
+, _type{0}
+, _remaining_length{0}
+, _length_shift{0}
+, _body_bytes{0}
+, _id_offset{0}
+, _packet_id{0}
+{
+
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void MqttPacketIdParser::feed(uint8_t const * data, size_t const length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    uint8_t const b = data[i];
+    switch (_state)
+    {
+      case State::Type:
+        _type = b;
+        _remaining_length = 0;
+        _length_shift = 0;
+        _body_bytes = 0;
+        /* The packet identifier of a PUBLISH follows its topic, the offset is known once the topic length is read */
+        _id_offset = (_packet_type == PacketType::Publish) ? 2 : 0;
+        _packet_id = 0;
+        _state = State::RemainingLength;
+        break;
+
+      case State::RemainingLength:
+        /* Variable length integer of up to 4 bytes, 7 bits per byte, least significant group first */
+        _remaining_length |= static_cast<uint32_t>(b & 0x7F) << _length_shift;
+        _length_shift += 7;
+        if ((b & 0x80) == 0 || _length_shift == 28) {
+          if (_remaining_length == 0) {
+            completePacket();
+          } else {
+            _state = State::Body;
+          }
+        }
+        break;
+
+      case State::Body:
+        if (hasPacketId() && _body_bytes < _id_offset + 2) {
+          parseBodyByte(b);
+          _body_bytes++;
+        } else {
+          /* Past the packet identifier only the length matters, skip the rest of the body at once */
+          size_t const skip = length - i;
+          size_t const left = _remaining_length - _body_bytes;
+          size_t const n = (skip < left) ? skip : left;
+          _body_bytes += n;
+          i += n - 1;
+        }
+        if (_body_bytes == _remaining_length) {
+          completePacket();
+        }
+        break;
+    }
+  }
+}
+
+void MqttPacketIdParser::reset()
+{
+  _state = State::Type;
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool MqttPacketIdParser::hasPacketId() const
+{
+  if ((_type & 0xF0) != static_cast<uint8_t>(_packet_type))
+    return false;
+
+  /* A PUBLISH carries a packet identifier only with QoS 1 or 2 */
+  return (_packet_type != PacketType::Publish) || ((_type & 0x06) != 0);
+}
+
+void MqttPacketIdParser::parseBodyByte(uint8_t const b)
+{
+  if (_packet_type == PacketType::Publish && _body_bytes < 2) {
+    /* Big endian topic length */
+    _id_offset = (_body_bytes == 0) ? (static_cast<uint32_t>(b) << 8) : (_id_offset | b);
+    if (_body_bytes == 1) {
+      _id_offset += 2;
+    }
+  } else if (_body_bytes == _id_offset) {
+    _packet_id = static_cast<uint16_t>(b) << 8;
+  } else if (_body_bytes == _id_offset + 1) {
+    _packet_id |= b;
+  }
+}
+
+void MqttPacketIdParser::completePacket()
+{
+  if (hasPacketId() && _body_bytes >= _id_offset + 2 && _on_packet_id) {
+    _on_packet_id(_packet_id);
+  }
+  _state = State::Type;
+}
@@ -0,0 +1,74 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_PACKET_ID_PARSER_H_
+#define ARDUINO_IOT_CLOUD_MQTT_PACKET_ID_PARSER_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Follows the packet framing of one direction of an MQTT stream and reports the
+ * packet identifier of every packet of the given type: the PUBLISH packets with
+ * QoS 1 or 2 sent to the broker, or the PUBACK packets received from it.
+ */
+class MqttPacketIdParser
+{
+public:
+
+  enum class PacketType : uint8_t
+  {
+    Publish = 0x30,
+    PubAck  = 0x40
+  };
+
+  typedef std::function<void(uint16_t const packet_id)> OnPacketId;
+
+  MqttPacketIdParser(PacketType const type, OnPacketId on_packet_id);
+
+  /* Parse the next length bytes of the stream */
+  void feed(uint8_t const * data, size_t const length);
+  /* A new connection starts a new stream */
+  void reset();
+
+private:
+
+  enum class State
+  {
+    Type,
+    RemainingLength,
+    Body
+  };
+
+  PacketType const _packet_type;
+  OnPacketId _on_packet_id;
+  State _state;
+  uint8_t _type;
+  uint32_t _remaining_length;
+  uint8_t _length_shift;
+  uint32_t _body_bytes;
+  uint32_t _id_offset;
+  uint16_t _packet_id;
+
+  bool hasPacketId() const;
+  void parseBodyByte(uint8_t const b);
+  void completePacket();
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_PACKET_ID_PARSER_H_ */
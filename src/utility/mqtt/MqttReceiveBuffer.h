@@ -0,0 +1,136 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_RECEIVE_BUFFER_H_
+#define ARDUINO_IOT_CLOUD_MQTT_RECEIVE_BUFFER_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Buffer an inbound MQTT message is read into with bulk reads, the decoders then
+ * work on it in place. It is allocated once. Larger messages up to max_length, e.g.
+ * the last values of a big Thing, get a one-off allocation released by release()
+ * or the next read(). Messages which still do not fit are drained from the client,
+ * dropped and counted, instead of being copied onto the stack.
+ */
+class MqttReceiveBuffer
+{
+public:
+
+  MqttReceiveBuffer() : _buf{nullptr}, _oversized{nullptr}, _size{0}, _max_length{0}, _length{0}, _dropped{0} { }
+  ~MqttReceiveBuffer() { delete[] _buf; delete[] _oversized; }
+
+  MqttReceiveBuffer(MqttReceiveBuffer const &) = delete;
+  MqttReceiveBuffer & operator = (MqttReceiveBuffer const &) = delete;
+
+  /* Allocate the buffer, the sizes can not be changed afterwards */
+  inline void begin(size_t const size, size_t const max_length = 0) {
+    if (_buf == nullptr) {
+      _buf = new uint8_t[size];
+      _size = size;
+      _max_length = (max_length > size) ? max_length : size;
+    }
+  }
+
+  /* Read the length bytes of the current message from client, which provides
+   * int read(uint8_t * buf, size_t size) like MqttClient. Return false if the
+   * message does not fit into the buffer or ends early, it is dropped then.
+   */
+  template <typename MqttClientType>
+  bool read(MqttClientType & client, size_t const length) {
+    _length = 0;
+    release();
+
+    uint8_t * dest = _buf;
+    if (length > _size) {
+      if ((_buf != nullptr) && (length <= _max_length)) {
+        _oversized = new (std::nothrow) uint8_t[length];
+      }
+      if (_oversized == nullptr) {
+        drain(client, length);
+        _dropped++;
+        return false;
+      }
+      dest = _oversized;
+    }
+
+    size_t const received = readInto(client, dest, length);
+    if (received < length) {
+      release();
+      _dropped++;
+      return false;
+    }
+
+    _length = length;
+    return true;
+  }
+
+  /* Free the one-off allocation of an oversized message once it has been handled */
+  inline void release() {
+    delete[] _oversized;
+    _oversized = nullptr;
+  }
+
+  inline uint8_t const * data          () const { return (_oversized != nullptr) ? _oversized : _buf; }
+  inline size_t          length        () const { return _length; }
+  inline size_t          size          () const { return _size; }
+  inline unsigned long   droppedMessages() const { return _dropped; }
+
+private:
+
+  uint8_t * _buf;
+  uint8_t * _oversized;
+  size_t _size;
+  size_t _max_length;
+  size_t _length;
+  unsigned long _dropped;
+
+  /* Return the number of bytes read, less than length if the client runs out of data */
+  template <typename MqttClientType>
+  static size_t readInto(MqttClientType & client, uint8_t * buf, size_t const length) {
+    size_t received = 0;
+    while (received < length) {
+      int const bytes_read = client.read(buf + received, length - received);
+      if (bytes_read <= 0) {
+        break;
+      }
+      received += bytes_read;
+    }
+    return received;
+  }
+
+  /* Consume the message chunk by chunk so that it does not linger in the client */
+  template <typename MqttClientType>
+  void drain(MqttClientType & client, size_t const length) {
+    uint8_t scratch[16];
+    uint8_t * chunk = (_size > 0) ? _buf : scratch;
+    size_t const chunk_size = (_size > 0) ? _size : sizeof(scratch);
+
+    for (size_t remaining = length; remaining > 0; ) {
+      size_t const to_read = (remaining < chunk_size) ? remaining : chunk_size;
+      size_t const received = readInto(client, chunk, to_read);
+      remaining -= received;
+      if (received < to_read) {
+        break;
+      }
+    }
+  }
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_RECEIVE_BUFFER_H_ */
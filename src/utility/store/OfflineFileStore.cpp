@@ -0,0 +1,226 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "OfflineFileStore.h"
+
+#if defined(HOST)
+
+#include <unistd.h>
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+OfflineFileStore::OfflineFileStore(char const * path, size_t const max_size)
+: _path{path}
+, _max_size{max_size}
+, _file{nullptr}
+, _read_offset{FILE_HEADER_SIZE}
+, _end_offset{FILE_HEADER_SIZE}
+, _count{0}
+{
+
+}
+
+OfflineFileStore::~OfflineFileStore()
+{
+  if (_file != nullptr) {
+    fclose(_file);
+  }
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool OfflineFileStore::begin()
+{
+  if (_file != nullptr)
+    return true;
+
+  _file = fopen(_path, "r+b");
+  if (_file == nullptr)
+    return reset();
+
+  uint8_t header[FILE_HEADER_SIZE];
+  if (fseek(_file, 0, SEEK_SET) != 0 || fread(header, 1, FILE_HEADER_SIZE, _file) != FILE_HEADER_SIZE)
+    return reset();
+
+  _read_offset = header[0] | (header[1] << 8) | (static_cast<size_t>(header[2]) << 16) | (static_cast<size_t>(header[3]) << 24);
+  if (_read_offset < FILE_HEADER_SIZE)
+    return reset();
+  _end_offset = _read_offset;
+  _count = 0;
+
+  /* Count the records left, a record cut short by a reset while it was written is discarded */
+  size_t length = 0;
+  while (readRecordLength(_end_offset, length)) {
+    if (fseek(_file, _end_offset + RECORD_HEADER_SIZE + length - 1, SEEK_SET) != 0 || fgetc(_file) == EOF)
+      break;
+    _end_offset += RECORD_HEADER_SIZE + length;
+    _count++;
+  }
+
+  if (_count == 0)
+    return reset();
+
+  /* Leftovers of a record cut short must not be mistaken for the next record pushed */
+  truncateFile(_end_offset);
+  return true;
+}
+
+bool OfflineFileStore::push(uint8_t const * data, size_t const length)
+{
+  if (_file == nullptr || length == 0 || length > UINT16_MAX || (_end_offset - _read_offset + RECORD_HEADER_SIZE + length) > _max_size) {
+    _dropped++;
+    return false;
+  }
+
+  uint8_t const header[RECORD_HEADER_SIZE] = {static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+  if (fseek(_file, _end_offset, SEEK_SET) != 0 ||
+      fwrite(header, 1, RECORD_HEADER_SIZE, _file) != RECORD_HEADER_SIZE ||
+      fwrite(data, 1, length, _file) != length ||
+      fflush(_file) != 0) {
+    _dropped++;
+    return false;
+  }
+
+  _end_offset += RECORD_HEADER_SIZE + length;
+  _count++;
+  return true;
+}
+
+size_t OfflineFileStore::peek(uint8_t * buf, size_t const size, size_t & count)
+{
+  size_t bytes = 0;
+  size_t offset = _read_offset;
+  count = 0;
+
+  size_t length = 0;
+  while (count < _count && readRecordLength(offset, length)) {
+    if ((bytes + length) > size)
+      break;
+    if (fread(buf + bytes, 1, length, _file) != length)
+      break;
+    bytes += length;
+    offset += RECORD_HEADER_SIZE + length;
+    count++;
+  }
+  return bytes;
+}
+
+void OfflineFileStore::pop(size_t const count)
+{
+  size_t length = 0;
+  for (size_t i = 0; i < count && _count > 0; i++) {
+    if (!readRecordLength(_read_offset, length)) {
+      reset();
+      return;
+    }
+    _read_offset += RECORD_HEADER_SIZE + length;
+    _count--;
+  }
+
+  if (_count == 0) {
+    reset();
+  } else if (_read_offset <= (_max_size / 2) || !compact()) {
+    writeFileHeader();
+  }
+}
+
+size_t OfflineFileStore::freeSpace() const
+{
+  size_t const used = _end_offset - _read_offset;
+  if (_file == nullptr || (used + RECORD_HEADER_SIZE) >= _max_size)
+    return 0;
+  size_t const space = _max_size - used - RECORD_HEADER_SIZE;
+  return (space > UINT16_MAX) ? UINT16_MAX : space;
+}
+
+void OfflineFileStore::clear()
+{
+  reset();
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+/* Truncate the file, the space of the removed records is only reclaimed here */
+bool OfflineFileStore::reset()
+{
+  if (_file != nullptr) {
+    fclose(_file);
+  }
+  _read_offset = FILE_HEADER_SIZE;
+  _end_offset = FILE_HEADER_SIZE;
+  _count = 0;
+
+  _file = fopen(_path, "w+b");
+  if (_file == nullptr)
+    return false;
+  return writeFileHeader();
+}
+
+/* The records are only moved once they fit below the oldest one, a reset during
+ * the copy leaves them in place and the file header unchanged.
+ */
+bool OfflineFileStore::compact()
+{
+  size_t const used = _end_offset - _read_offset;
+  if (used > (_read_offset - FILE_HEADER_SIZE))
+    return false;
+
+  uint8_t buf[64];
+  for (size_t moved = 0; moved < used; ) {
+    size_t const n = ((used - moved) < sizeof(buf)) ? (used - moved) : sizeof(buf);
+    if (fseek(_file, _read_offset + moved, SEEK_SET) != 0 || fread(buf, 1, n, _file) != n ||
+        fseek(_file, FILE_HEADER_SIZE + moved, SEEK_SET) != 0 || fwrite(buf, 1, n, _file) != n)
+      return false;
+    moved += n;
+  }
+
+  _read_offset = FILE_HEADER_SIZE;
+  _end_offset = FILE_HEADER_SIZE + used;
+  return writeFileHeader() && truncateFile(_end_offset);
+}
+
+bool OfflineFileStore::truncateFile(size_t const length)
+{
+  return fflush(_file) == 0 && ftruncate(fileno(_file), static_cast<off_t>(length)) == 0;
+}
+
+bool OfflineFileStore::writeFileHeader()
+{
+  uint8_t const header[FILE_HEADER_SIZE] = {
+    static_cast<uint8_t>(_read_offset & 0xFF),
+    static_cast<uint8_t>((_read_offset >> 8) & 0xFF),
+    static_cast<uint8_t>((_read_offset >> 16) & 0xFF),
+    static_cast<uint8_t>((_read_offset >> 24) & 0xFF)
+  };
+  return fseek(_file, 0, SEEK_SET) == 0 &&
+         fwrite(header, 1, FILE_HEADER_SIZE, _file) == FILE_HEADER_SIZE &&
+         fflush(_file) == 0;
+}
+
+bool OfflineFileStore::readRecordLength(size_t const offset, size_t & length)
+{
+  uint8_t header[RECORD_HEADER_SIZE];
+  if (fseek(_file, offset, SEEK_SET) != 0 || fread(header, 1, RECORD_HEADER_SIZE, _file) != RECORD_HEADER_SIZE)
+    return false;
+  length = header[0] | (static_cast<size_t>(header[1]) << 8);
+  return length > 0;
+}
+
+#endif /* HOST */
@@ -0,0 +1,78 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_OFFLINE_FILE_STORE_H_
+#define ARDUINO_IOT_CLOUD_OFFLINE_FILE_STORE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "OfflineStore.h"
+
+/* Relies on POSIX ftruncate() to reclaim space, which the file APIs of the boards do not
+ * provide in the same form, only host builds are supported until it is ported to them.
+ */
+#if defined(HOST)
+
+#include <stdio.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Records appended to a file, which survives a reset, up to max_size bytes of records
+ * and their two byte length. The file system holding path has to be mounted before
+ * begin(). The file starts with the offset of the oldest record, the space of the
+ * removed records is reclaimed once every record has been removed or the oldest
+ * record is past half of max_size, so the file stays below twice max_size.
+ */
+class OfflineFileStore : public OfflineStore
+{
+public:
+
+  OfflineFileStore(char const * path, size_t const max_size);
+  virtual ~OfflineFileStore();
+
+  OfflineFileStore(OfflineFileStore const &) = delete;
+  OfflineFileStore & operator = (OfflineFileStore const &) = delete;
+
+  virtual bool   begin() override;
+  virtual bool   push(uint8_t const * data, size_t const length) override;
+  virtual size_t peek(uint8_t * buf, size_t const size, size_t & count) override;
+  virtual void   pop(size_t const count) override;
+  virtual size_t count() const override { return _count; }
+  virtual size_t freeSpace() const override;
+  virtual void   clear() override;
+
+private:
+
+  static size_t const FILE_HEADER_SIZE = 4;
+  static size_t const RECORD_HEADER_SIZE = 2;
+
+  char const * _path;
+  size_t _max_size;
+  FILE * _file;
+  size_t _read_offset;
+  size_t _end_offset;
+  size_t _count;
+
+  bool   reset();
+  /* Move the records to the start of the file */
+  bool   compact();
+  bool   truncateFile(size_t const length);
+  bool   writeFileHeader();
+  /* Return false if there is no complete record header at offset */
+  bool   readRecordLength(size_t const offset, size_t & length);
+};
+
+#endif /* HOST */
+
+#endif /* ARDUINO_IOT_CLOUD_OFFLINE_FILE_STORE_H_ */
@@ -0,0 +1,136 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "OfflineRamStore.h"
+
+#include <string.h>
+
+/******************************************************************************
+   CTOR/DTOR
+ ******************************************************************************/
+
+OfflineRamStore::OfflineRamStore(size_t const capacity)
+: _buf{nullptr}
+, _capacity{capacity}
+, _head{0}
+, _used{0}
+, _count{0}
+{
+
+}
+
+OfflineRamStore::~OfflineRamStore()
+{
+  delete[] _buf;
+}
+
+/******************************************************************************
+   PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool OfflineRamStore::begin()
+{
+  if (_buf == nullptr && _capacity > 0) {
+    _buf = new uint8_t[_capacity];
+  }
+  return _buf != nullptr;
+}
+
+bool OfflineRamStore::push(uint8_t const * data, size_t const length)
+{
+  if (_buf == nullptr || length == 0 || length > UINT16_MAX || (_used + HEADER_SIZE + length) > _capacity) {
+    _dropped++;
+    return false;
+  }
+
+  uint8_t const header[HEADER_SIZE] = {static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+  size_t const tail = (_head + _used) % _capacity;
+  write(tail, header, HEADER_SIZE);
+  write((tail + HEADER_SIZE) % _capacity, data, length);
+  _used += HEADER_SIZE + length;
+  _count++;
+  return true;
+}
+
+size_t OfflineRamStore::peek(uint8_t * buf, size_t const size, size_t & count)
+{
+  size_t bytes = 0;
+  size_t pos = _head;
+  count = 0;
+
+  while (count < _count) {
+    size_t const length = recordLength(pos);
+    if ((bytes + length) > size)
+      break;
+    read((pos + HEADER_SIZE) % _capacity, buf + bytes, length);
+    bytes += length;
+    pos = (pos + HEADER_SIZE + length) % _capacity;
+    count++;
+  }
+  return bytes;
+}
+
+void OfflineRamStore::pop(size_t const count)
+{
+  for (size_t i = 0; i < count && _count > 0; i++) {
+    size_t const record_size = HEADER_SIZE + recordLength(_head);
+    _head = (_head + record_size) % _capacity;
+    _used -= record_size;
+    _count--;
+  }
+  if (_count == 0) {
+    _head = 0;
+  }
+}
+
+size_t OfflineRamStore::freeSpace() const
+{
+  if (_buf == nullptr || (_used + HEADER_SIZE) >= _capacity)
+    return 0;
+  size_t const space = _capacity - _used - HEADER_SIZE;
+  return (space > UINT16_MAX) ? UINT16_MAX : space;
+}
+
+void OfflineRamStore::clear()
+{
+  _head = 0;
+  _used = 0;
+  _count = 0;
+}
+
+/******************************************************************************
+   PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+/* Copy in at most two chunks, the ring may wrap around once */
+void OfflineRamStore::write(size_t const pos, uint8_t const * data, size_t const length)
+{
+  size_t const first = (length < (_capacity - pos)) ? length : (_capacity - pos);
+  memcpy(_buf + pos, data, first);
+  memcpy(_buf, data + first, length - first);
+}
+
+void OfflineRamStore::read(size_t const pos, uint8_t * data, size_t const length) const
+{
+  size_t const first = (length < (_capacity - pos)) ? length : (_capacity - pos);
+  memcpy(data, _buf + pos, first);
+  memcpy(data + first, _buf, length - first);
+}
+
+size_t OfflineRamStore::recordLength(size_t const pos) const
+{
+  uint8_t header[HEADER_SIZE];
+  read(pos, header, HEADER_SIZE);
+  return header[0] | (static_cast<size_t>(header[1]) << 8);
+}
@@ -0,0 +1,60 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_OFFLINE_RAM_STORE_H_
+#define ARDUINO_IOT_CLOUD_OFFLINE_RAM_STORE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include "OfflineStore.h"
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Ring of capacity bytes allocated once by begin(), each record takes two more bytes
+ * for its length. The records are lost on reset.
+ */
+class OfflineRamStore : public OfflineStore
+{
+public:
+
+  OfflineRamStore(size_t const capacity);
+  virtual ~OfflineRamStore();
+
+  OfflineRamStore(OfflineRamStore const &) = delete;
+  OfflineRamStore & operator = (OfflineRamStore const &) = delete;
+
+  virtual bool   begin() override;
+  virtual bool   push(uint8_t const * data, size_t const length) override;
+  virtual size_t peek(uint8_t * buf, size_t const size, size_t & count) override;
+  virtual void   pop(size_t const count) override;
+  virtual size_t count() const override { return _count; }
+  virtual size_t freeSpace() const override;
+  virtual void   clear() override;
+
+private:
+
+  static size_t const HEADER_SIZE = 2;
+
+  uint8_t * _buf;
+  size_t _capacity;
+  size_t _head;
+  size_t _used;
+  size_t _count;
+
+  void   write(size_t const pos, uint8_t const * data, size_t const length);
+  void   read(size_t const pos, uint8_t * data, size_t const length) const;
+  size_t recordLength(size_t const pos) const;
+};
+
+#endif /* ARDUINO_IOT_CLOUD_OFFLINE_RAM_STORE_H_ */
@@ -0,0 +1,59 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_OFFLINE_STORE_H_
+#define ARDUINO_IOT_CLOUD_OFFLINE_STORE_H_
+
+/******************************************************************************
+   INCLUDE
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+   CLASS DECLARATION
+ ******************************************************************************/
+
+/* Backend of the store-and-forward of property updates: a FIFO of records, each
+ * one holding the encoded CBOR records of a property. The records are kept in the
+ * order they are pushed and are only removed by pop(), once they are published.
+ */
+class OfflineStore
+{
+public:
+
+  OfflineStore() : _dropped{0} { }
+  virtual ~OfflineStore() { }
+
+  /* Allocate or open the storage, return false if it is not usable */
+  virtual bool   begin() = 0;
+  /* Append a record, return false if it does not fit, it is dropped and counted then */
+  virtual bool   push(uint8_t const * data, size_t const length) = 0;
+  /* Copy the oldest records that fit as a whole into size bytes, back to back, without
+   * removing them. Return the number of bytes copied and set count to the number of records.
+   */
+  virtual size_t peek(uint8_t * buf, size_t const size, size_t & count) = 0;
+  /* Remove the count oldest records */
+  virtual void   pop(size_t const count) = 0;
+  virtual size_t count() const = 0;
+  /* Largest record push() accepts at the moment */
+  virtual size_t freeSpace() const = 0;
+  virtual void   clear() = 0;
+
+  inline bool          empty         () const { return count() == 0; }
+  inline unsigned long droppedRecords() const { return _dropped; }
+
+protected:
+
+  unsigned long _dropped;
+};
+
+#endif /* ARDUINO_IOT_CLOUD_OFFLINE_STORE_H_ */
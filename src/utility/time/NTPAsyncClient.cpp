@@ -0,0 +1,133 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "../../AIoTC_Config.h"
+#ifndef HAS_LORA
+
+#include "NTPAsyncClient.h"
+#include "NTPUtils.h"
+
+/**************************************************************************************
+ * CONSTANTS
+ **************************************************************************************/
+
+static char const * const NTP_TIME_SERVERS[] =
+{
+  "time.arduino.cc",
+  "pool.ntp.org",
+  "time.google.com"
+};
+
+static unsigned int const NTP_TIME_SERVER_COUNT = sizeof(NTP_TIME_SERVERS) / sizeof(NTP_TIME_SERVERS[0]);
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+NTPAsyncClient::NTPAsyncClient()
+: _state{State::Idle}
+, _attempt{0}
+, _state_start_ms{0}
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+NTPAsyncClient::Status NTPAsyncClient::poll(UDP & udp, unsigned long & time)
+{
+  switch (_state)
+  {
+  case State::Idle:
+#if NTP_USE_RANDOM_PORT
+    udp.begin(NTPUtils::getRandomPort(NTPUtils::MIN_NTP_PORT, NTPUtils::MAX_NTP_PORT));
+#else
+    udp.begin(NTPUtils::NTP_LOCAL_PORT);
+#endif
+    _attempt = 0;
+    send(udp);
+    return Status::Pending;
+
+  case State::WaitResponse:
+    if (udp.parsePacket()) {
+      uint8_t ntp_packet_buf[NTPUtils::NTP_PACKET_SIZE] = {0};
+      udp.read(ntp_packet_buf, NTPUtils::NTP_PACKET_SIZE);
+      unsigned long const epoch = NTPUtils::parseNTPpacket(ntp_packet_buf);
+      /* A corrupted answer counts as an unanswered attempt */
+      if (epoch == 0) {
+        return retry(udp);
+      }
+      stop(udp);
+      time = epoch;
+      return Status::Done;
+    }
+    if ((millis() - _state_start_ms) < NTP_TIMEOUT_MS) {
+      return Status::Pending;
+    }
+    return retry(udp);
+
+  case State::WaitRetry:
+    if ((millis() - _state_start_ms) >= retryDelay()) {
+      send(udp);
+    }
+    return Status::Pending;
+  }
+
+  return Status::Failed;
+}
+
+void NTPAsyncClient::stop(UDP & udp)
+{
+  if (_state != State::Idle) {
+    udp.stop();
+    _state = State::Idle;
+  }
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void NTPAsyncClient::send(UDP & udp)
+{
+  NTPUtils::sendNTPpacket(udp, NTP_TIME_SERVERS[_attempt % NTP_TIME_SERVER_COUNT]);
+  _state = State::WaitResponse;
+  _state_start_ms = millis();
+}
+
+NTPAsyncClient::Status NTPAsyncClient::retry(UDP & udp)
+{
+  _attempt++;
+  if (_attempt >= NTP_MAX_ATTEMPTS) {
+    stop(udp);
+    return Status::Failed;
+  }
+  _state = State::WaitRetry;
+  _state_start_ms = millis();
+  return Status::Pending;
+}
+
+/* NTP_RETRY_DELAY_MS before the first retry, doubled for each one after it */
+unsigned long NTPAsyncClient::retryDelay() const
+{
+  unsigned long delay_ms = NTP_RETRY_DELAY_MS;
+  for (unsigned int i = 1; i < _attempt && delay_ms < NTP_MAX_RETRY_DELAY_MS; i++) {
+    delay_ms *= 2;
+  }
+  return (delay_ms < NTP_MAX_RETRY_DELAY_MS) ? delay_ms : NTP_MAX_RETRY_DELAY_MS;
+}
+
+#endif /* #ifndef HAS_LORA */
@@ -0,0 +1,79 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_NTP_ASYNC_CLIENT_H_
+#define ARDUINO_IOT_CLOUD_NTP_ASYNC_CLIENT_H_
+
+#include "../../AIoTC_Config.h"
+#ifndef HAS_LORA
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <Arduino.h>
+#include <Udp.h>
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* NTP request which never waits for the answer: poll() sends it and returns, the
+ * following calls check whether the answer has arrived. Unanswered requests are
+ * retried on the next server, waiting twice as long before each retry.
+ */
+class NTPAsyncClient
+{
+public:
+
+  enum class Status
+  {
+    Pending,
+    Done,
+    Failed
+  };
+
+  NTPAsyncClient();
+
+  /* Start a request if none is in flight, otherwise check on it. Return Done and set time
+   * to the UTC epoch once answered, Failed once every attempt went unanswered.
+   */
+  Status poll(UDP & udp, unsigned long & time);
+  /* Abandon the request in flight */
+  void   stop(UDP & udp);
+
+  inline bool isPending() const { return _state != State::Idle; }
+
+  static unsigned long const NTP_TIMEOUT_MS         = 1000;
+  static unsigned long const NTP_RETRY_DELAY_MS     = 500;
+  static unsigned long const NTP_MAX_RETRY_DELAY_MS = 4000;
+  static unsigned int  const NTP_MAX_ATTEMPTS       = 6;
+
+private:
+
+  enum class State
+  {
+    Idle,
+    WaitResponse,
+    WaitRetry
+  };
+
+  State _state;
+  unsigned int _attempt;
+  unsigned long _state_start_ms;
+
+  void          send(UDP & udp);
+  Status        retry(UDP & udp);
+  unsigned long retryDelay() const;
+};
+
+#endif /* #ifndef HAS_LORA */
+
+#endif /* ARDUINO_IOT_CLOUD_NTP_ASYNC_CLIENT_H_ */
@@ -33,32 +33,26 @@
  * PUBLIC MEMBER FUNCTIONS
  **************************************************************************************/
 
-unsigned long NTPUtils::getTime(UDP & udp)
+void NTPUtils::sendNTPpacket(UDP & udp, char const * server)
 {
-#ifdef NTP_USE_RANDOM_PORT
-  udp.begin(NTPUtils::getRandomPort(MIN_NTP_PORT, MAX_NTP_PORT));
-#else
-  udp.begin(NTP_LOCAL_PORT);
-#endif
-
-  sendNTPpacket(udp);
-
-  bool is_timeout = false;
-  unsigned long const start = millis();
-  do
-  {
-    is_timeout = (millis() - start) >= NTP_TIMEOUT_MS;
-  } while(!is_timeout && !udp.parsePacket());
+  uint8_t ntp_packet_buf[NTP_PACKET_SIZE] = {0};
 
-  if(is_timeout) {
-    udp.stop();
-    return 0;
-  }
+  ntp_packet_buf[0]  = 0xE3; /* LI = 3 (unsynchronized), VN = 4, Mode = 3 (client) */
+  ntp_packet_buf[1]  = 0;
+  ntp_packet_buf[2]  = 6;
+  ntp_packet_buf[3]  = 0xEC;
+  ntp_packet_buf[12] = 49;
+  ntp_packet_buf[13] = 0x4E;
+  ntp_packet_buf[14] = 49;
+  ntp_packet_buf[15] = 52;
 
-  uint8_t ntp_packet_buf[NTP_PACKET_SIZE];
-  udp.read(ntp_packet_buf, NTP_PACKET_SIZE);
-  udp.stop();
+  udp.beginPacket(server, NTP_TIME_SERVER_PORT);
+  udp.write(ntp_packet_buf, NTP_PACKET_SIZE);
+  udp.endPacket();
+}
 
+unsigned long NTPUtils::parseNTPpacket(uint8_t const * ntp_packet_buf)
+{
   unsigned long const highWord      = word(ntp_packet_buf[40], ntp_packet_buf[41]);
   unsigned long const lowWord       = word(ntp_packet_buf[42], ntp_packet_buf[43]);
   unsigned long const secsSince1900 = highWord << 16 | lowWord;
@@ -74,28 +68,6 @@ unsigned long NTPUtils::getTime(UDP & udp)
   return epoch;
 }
 
-/**************************************************************************************
- * PRIVATE MEMBER FUNCTIONS
- **************************************************************************************/
-
-void NTPUtils::sendNTPpacket(UDP & udp)
-{
-  uint8_t ntp_packet_buf[NTP_PACKET_SIZE] = {0};
-
-  ntp_packet_buf[0]  = 0b11100011;
-  ntp_packet_buf[1]  = 0;
-  ntp_packet_buf[2]  = 6;
-  ntp_packet_buf[3]  = 0xEC;
-  ntp_packet_buf[12] = 49;
-  ntp_packet_buf[13] = 0x4E;
-  ntp_packet_buf[14] = 49;
-  ntp_packet_buf[15] = 52;
-
-  udp.beginPacket(NTP_TIME_SERVER, NTP_TIME_SERVER_PORT);
-  udp.write(ntp_packet_buf, NTP_PACKET_SIZE);
-  udp.endPacket();
-}
-
 int NTPUtils::getRandomPort(int const min_port, int const max_port)
 {
 #if defined (BOARD_HAS_ECCX08)
@@ -37,26 +37,27 @@
  * CLASS DECLARATION
  **************************************************************************************/
 
+/* Helpers of the NTP exchange run by NTPAsyncClient, which waits for the answer without blocking the loop */
 class NTPUtils
 {
 public:
 
-  static unsigned long getTime(UDP & udp);
   static int getRandomPort(int const min_port, int const max_port);
 
-private:
+  static void sendNTPpacket(UDP & udp, char const * server);
+  /* Return the UTC epoch of the answer in ntp_packet_buf, 0 if it is corrupted */
+  static unsigned long parseNTPpacket(uint8_t const * ntp_packet_buf);
 
   static size_t        const NTP_PACKET_SIZE      = 48;
-  static int           const NTP_TIME_SERVER_PORT = 123;
   static int           const NTP_LOCAL_PORT       = 8888;
 #if NTP_USE_RANDOM_PORT
   static int           const MIN_NTP_PORT         = 49152;
   static int           const MAX_NTP_PORT         = 65535;
 #endif
-  static unsigned long const NTP_TIMEOUT_MS       = 1000;
-  static constexpr const char * NTP_TIME_SERVER   = "time.arduino.cc";
 
-  static void sendNTPpacket(UDP & udp);
+private:
+
+  static int           const NTP_TIME_SERVER_PORT = 123;
 };
 
 #endif /* #ifndef HAS_LORA */
@@ -20,6 +20,7 @@
  **************************************************************************************/
 
 
+#include <limits.h>
 #include <time.h>
 
 #include "AIoTC_Config.h"
@@ -123,6 +124,7 @@ TimeServiceClass::TimeServiceClass()
 , _timezone_dst_until(0)
 , _last_sync_tick(0)
 , _sync_interval_ms(TIMESERVICE_NTP_SYNC_TIMEOUT_ms)
+, _max_drift_ppm(AIOT_CONFIG_TIMESERVICE_MAX_DRIFT_ppm)
 , _sync_func(nullptr)
 {
 
@@ -164,15 +166,24 @@ unsigned long TimeServiceClass::getTime()
   return EPOCH_AT_COMPILE_TIME;
 }
 
+uint64_t TimeServiceClass::getTimeMillis()
+{
+  /* Sync first if it is time to */
+  unsigned long const utc = getTime();
+  if(_millis_clock.isSynced()) {
+    return _millis_clock.getTimeMillis();
+  }
+  return static_cast<uint64_t>(utc) * 1000ULL;
+}
+
 void TimeServiceClass::setTime(unsigned long time)
 {
   setRTC(time);
+  _millis_clock.sync(time);
 }
 
 bool TimeServiceClass::sync()
 {
-  _is_rtc_configured = false;
-
   unsigned long utc = EPOCH;
   if(_sync_func) {
     utc = _sync_func();
@@ -188,10 +199,26 @@ bool TimeServiceClass::sync()
   if(isTimeValid(utc)) {
     DEBUG_DEBUG("TimeServiceClass::%s done. Drift: %d RTC value: %u", __FUNCTION__, getRTC() - utc, utc);
     setRTC(utc);
+    _millis_clock.sync(utc);
     _last_sync_tick = millis();
     _is_rtc_configured = true;
+    return true;
   }
-  return _is_rtc_configured;
+
+  /* The RTC keeps its configuration while a network time request is in flight */
+  if(!isSyncPending()) {
+    _is_rtc_configured = false;
+  }
+  return false;
+}
+
+bool TimeServiceClass::isSyncPending()
+{
+#ifdef HAS_TCP
+  return _ntp_client.isPending();
+#else
+  return false;
+#endif
 }
 
 void TimeServiceClass::setSyncInterval(unsigned long seconds)
@@ -206,6 +233,37 @@ void TimeServiceClass::setSyncFunction(syncTimeFunctionPtr sync_func)
   }
 }
 
+unsigned long TimeServiceClass::getSyncAge()
+{
+  if(!_last_sync_tick) {
+    return ULONG_MAX;
+  }
+  return millis() - _last_sync_tick;
+}
+
+void TimeServiceClass::setMaxDrift(unsigned long ppm)
+{
+  _max_drift_ppm = ppm;
+  _millis_clock.setMaxDrift(ppm);
+}
+
+bool TimeServiceClass::isTimeTrusted(unsigned long const max_drift_ms)
+{
+  /* A failed sync attempt leaves the RTC unconfigured */
+  if(!_is_rtc_configured || !_last_sync_tick) {
+    return false;
+  }
+
+  /* Past the sync interval getTime() syncs again anyway */
+  unsigned long const sync_age_ms = getSyncAge();
+  if(sync_age_ms > _sync_interval_ms) {
+    return false;
+  }
+
+  unsigned long long const drift_ms = static_cast<unsigned long long>(sync_age_ms) * _max_drift_ppm / 1000000ULL;
+  return drift_ms <= max_drift_ms;
+}
+
 void TimeServiceClass::setTimeZoneData(long offset, unsigned long dst_until)
 {
   if(isTimeZoneOffsetValid(offset) && isTimeValid(dst_until)) {
@@ -309,8 +367,13 @@ unsigned long TimeServiceClass::getRemoteTime()
      * ensure a correct behaviour of the library.
      */
     if(_con_hdl->getInterface() != NetworkAdapter::CELL) {
-      unsigned long const ntp_time = NTPUtils::getTime(_con_hdl->getUDP());
-      if(isTimeValid(ntp_time)) {
+      unsigned long ntp_time = EPOCH;
+      NTPAsyncClient::Status const ntp_status = _ntp_client.poll(_con_hdl->getUDP(), ntp_time);
+      if(ntp_status == NTPAsyncClient::Status::Pending) {
+        /* The answer is collected by one of the next calls */
+        return EPOCH;
+      }
+      if(ntp_status == NTPAsyncClient::Status::Done && isTimeValid(ntp_time)) {
         return ntp_time;
       }
     }
@@ -326,6 +389,12 @@ unsigned long TimeServiceClass::getRemoteTime()
     }
     DEBUG_WARNING("TimeServiceClass::%s cannot get time from connection handler", __FUNCTION__);
   }
+#ifdef HAS_TCP
+  else if(_con_hdl != nullptr) {
+    /* The connection has been lost while waiting for the answer */
+    _ntp_client.stop(_con_hdl->getUDP());
+  }
+#endif
 
   /* Return known invalid value because we are not connected */
   return EPOCH;
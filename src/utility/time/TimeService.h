@@ -24,6 +24,11 @@
 
 #include <AIoTC_Config.h>
 #include <Arduino_ConnectionHandler.h>
+#include "UTCMillisClock.h"
+
+#ifdef HAS_TCP
+  #include "NTPAsyncClient.h"
+#endif
 
 /******************************************************************************
  * TYPEDEF
@@ -44,12 +49,26 @@ public:
 
   void          begin  (ConnectionHandler * con_hdl);
   unsigned long getTime();
+  /* UTC time in milliseconds, corrected for the drift of millis() measured between syncs */
+  uint64_t      getTimeMillis();
   void          setTime(unsigned long time);
   unsigned long getLocalTime();
   void          setTimeZoneData(long offset, unsigned long valid_until);
+  /* Return true if the time has been synced by this call. A network time request does not wait
+   * for the answer, which is collected by one of the next calls while isSyncPending() is true.
+   */
   bool          sync();
+  bool          isSyncPending();
   void          setSyncInterval(unsigned long seconds);
   void          setSyncFunction(syncTimeFunctionPtr sync_func);
+  /* Milliseconds elapsed since the last successful sync, ULONG_MAX if there was none */
+  unsigned long getSyncAge();
+  /* Worst case drift of the RTC in parts per million, it bounds the RTC error since the last sync */
+  void          setMaxDrift(unsigned long ppm);
+  /* Return true if the RTC has been synced and has drifted by at most max_drift_ms since then,
+   * in that case there is no need to sync it again when reconnecting.
+   */
+  bool          isTimeTrusted(unsigned long const max_drift_ms = AIOT_CONFIG_TIMESERVICE_MAX_TRUSTED_DRIFT_ms);
 
   /* Helper function to convert an input String into a UNIX timestamp.
    * The input String format must be as follow "2021 Nov 01 17:00:00"
@@ -67,7 +86,12 @@ private:
   unsigned long _timezone_dst_until;
   unsigned long _last_sync_tick;
   unsigned long _sync_interval_ms;
+  unsigned long _max_drift_ppm;
   syncTimeFunctionPtr _sync_func;
+  UTCMillisClock _millis_clock;
+#ifdef HAS_TCP
+  NTPAsyncClient _ntp_client;
+#endif
 
 #if defined(HAS_NOTECARD) || defined(HAS_TCP)
   unsigned long getRemoteTime();
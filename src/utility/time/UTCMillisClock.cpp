@@ -0,0 +1,91 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include "../../AIoTC_Config.h"
+#include "UTCMillisClock.h"
+
+/**************************************************************************************
+ * CTOR/DTOR
+ **************************************************************************************/
+
+UTCMillisClock::UTCMillisClock()
+: _sync_utc_ms{0}
+, _sync_tick{0}
+, _last_time_ms{0}
+, _last_millis{0}
+, _millis_wraps{0}
+, _max_drift_ppm{AIOT_CONFIG_TIMESERVICE_MAX_DRIFT_ppm}
+, _drift_ppm{0}
+, _is_synced{false}
+{
+
+}
+
+/**************************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ **************************************************************************************/
+
+void UTCMillisClock::sync(unsigned long const utc)
+{
+  uint64_t const now = tick();
+  uint64_t const utc_ms = static_cast<uint64_t>(utc) * 1000ULL;
+
+  if (_is_synced) {
+    uint64_t const elapsed_ms = now - _sync_tick;
+    if (elapsed_ms >= MIN_DRIFT_MEASUREMENT_MS) {
+      /* Compare the UTC and millis() time elapsed since the last sync, without the correction applied so far */
+      int64_t const error_ms = static_cast<int64_t>(utc_ms - _sync_utc_ms) - static_cast<int64_t>(elapsed_ms);
+      int64_t drift_ppm = error_ms * 1000000LL / static_cast<int64_t>(elapsed_ms);
+      int64_t const max_drift_ppm = static_cast<int64_t>(_max_drift_ppm);
+      if (drift_ppm >  max_drift_ppm) drift_ppm =  max_drift_ppm;
+      if (drift_ppm < -max_drift_ppm) drift_ppm = -max_drift_ppm;
+      _drift_ppm = static_cast<long>(drift_ppm);
+    }
+  }
+
+  _sync_utc_ms = utc_ms;
+  _sync_tick = now;
+  _is_synced = true;
+}
+
+uint64_t UTCMillisClock::getTimeMillis()
+{
+  if (!_is_synced) {
+    return 0;
+  }
+
+  uint64_t const elapsed_ms = tick() - _sync_tick;
+  int64_t const correction_ms = static_cast<int64_t>(elapsed_ms) * _drift_ppm / 1000000LL;
+  uint64_t time_ms = _sync_utc_ms + elapsed_ms + correction_ms;
+
+  if (time_ms < _last_time_ms) {
+    time_ms = _last_time_ms;
+  }
+  _last_time_ms = time_ms;
+  return time_ms;
+}
+
+/**************************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ **************************************************************************************/
+
+uint64_t UTCMillisClock::tick()
+{
+  uint32_t const now = static_cast<uint32_t>(millis());
+  if (now < _last_millis) {
+    _millis_wraps++;
+  }
+  _last_millis = now;
+  return (static_cast<uint64_t>(_millis_wraps) << 32) | now;
+}
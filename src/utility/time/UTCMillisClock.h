@@ -0,0 +1,66 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_UTC_MILLIS_CLOCK_H_
+#define ARDUINO_IOT_CLOUD_UTC_MILLIS_CLOCK_H_
+
+/**************************************************************************************
+ * INCLUDE
+ **************************************************************************************/
+
+#include <Arduino.h>
+
+/**************************************************************************************
+ * CLASS DECLARATION
+ **************************************************************************************/
+
+/* UTC time in milliseconds, counted with millis() from the last sync. The drift of
+ * millis() against UTC is measured between two syncs far enough apart and corrected
+ * until the next one. millis() wrapping around is accounted for as long as the
+ * clock is read at least once every 49 days.
+ */
+class UTCMillisClock
+{
+public:
+
+  UTCMillisClock();
+
+  /* Anchor the clock to utc, in seconds, at the current millis() */
+  void     sync(unsigned long const utc);
+  /* Return 0 until the first sync. The time never goes backwards, a sync which
+   * would move it back holds it until UTC catches up.
+   */
+  uint64_t getTimeMillis();
+
+  /* Drift corrections are bounded to ppm parts per million */
+  inline void setMaxDrift(unsigned long const ppm) { _max_drift_ppm = ppm; }
+  inline bool isSynced() const { return _is_synced; }
+  /* Measured drift of millis() against UTC, positive if millis() is slow */
+  inline long driftPpm() const { return _drift_ppm; }
+
+  /* Syncs are whole seconds, below this distance the drift measurement is too coarse */
+  static unsigned long const MIN_DRIFT_MEASUREMENT_MS = 6UL * 60UL * 60UL * 1000UL;
+
+private:
+
+  uint64_t _sync_utc_ms;
+  uint64_t _sync_tick;
+  uint64_t _last_time_ms;
+  uint32_t _last_millis;
+  uint32_t _millis_wraps;
+  unsigned long _max_drift_ppm;
+  long _drift_ppm;
+  bool _is_synced;
+
+  /* millis() extended to 64 bit */
+  uint64_t tick();
+};
+
+#endif /* ARDUINO_IOT_CLOUD_UTC_MILLIS_CLOCK_H_ */